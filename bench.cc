@@ -0,0 +1,2 @@
+#define SOLE_BUILD_BENCH
+#include "sole.hpp"
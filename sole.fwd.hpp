@@ -2,11 +2,28 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <string>
+#include <vector>
 namespace sole {
     struct uuid;
+    class pool;
+    class deterministic_generator;
     uuid uuid0();
     uuid uuid1();
     uuid uuid4();
+    uuid uuid6();
+    uuid uuid7();
+    uuid uuid3( const uuid &ns, const std::string &name );
+    uuid uuid5( const uuid &ns, const std::string &name );
+    void uuid0_n( uuid *out, size_t n );
+    void uuid1_n( uuid *out, size_t n );
+    void uuid4_n( uuid *out, size_t n );
+    void uuid6_n( uuid *out, size_t n );
+    void uuid7_n( uuid *out, size_t n );
+    std::vector<uuid> uuid0_n( size_t n );
+    std::vector<uuid> uuid1_n( size_t n );
+    std::vector<uuid> uuid4_n( size_t n );
+    std::vector<uuid> uuid6_n( size_t n );
+    std::vector<uuid> uuid7_n( size_t n );
     uuid rebuild( uint64_t ab, uint64_t cd );
     uuid rebuild( const std::string &uustr );
 }
\ No newline at end of file
@@ -1,5 +1,5 @@
 /* Sole is a lightweight C++11 library to generate universally unique identificators.
- * Sole provides interface for UUID versions 0, 1 and 4.
+ * Sole provides interface for UUID versions 0, 1, 4, 6 and 7.
 
  * https://github.com/r-lyeh/sole
  * Copyright (c) 2013,2014,2015 r-lyeh. zlib/libpng licensed.
@@ -16,6 +16,9 @@
  * - UUID Version 4 (122-bits of randomness)
  *   See [2] or other analysis that describe how very unlikely a duplicate is.
  *
+ * - UUID Version 7 (48-bit Unix epoch in ms + 74-bits of counter and randomness, RFC 9562)
+ *   Sorts by creation time, which keeps B-tree inserts local.
+ *
  * - Use v1 if you need to sort or classify UUIDs per machine.
  *   Use v1 if you are worried about leaving it up to probabilities (e.g. your are the
  *   type of person worried about the earth getting destroyed by a large asteroid in your
@@ -51,6 +54,7 @@
 #include <sys/types.h> // for uint32_t; should be stdint.h instead; however, GCC 5 on OSX fails when compiling it (See issue #11)
 #include <functional>
 #include <string>
+#include <vector>
 
 // public API
 
@@ -61,27 +65,43 @@
 #define SOLE_VERSION "1.0.1" // (2017/05/16): Improve UUID4 and base62 performance; fix warnings
 #define SOLE_VERSION "1.0.0" // (2016/02/03): Initial semver adherence; Switch to header-only; Remove warnings */
 
+// Define SOLE_ALIGN16 to align sole::uuid to 16 bytes, so SIMD paths can use aligned
+// loads and single-instruction compares. Containers holding uuids may grow padding.
+#ifdef SOLE_ALIGN16
+#   define SOLE_UUID_ALIGN alignas(16)
+#else
+#   define SOLE_UUID_ALIGN
+#endif
+
 namespace sole
 {
     // 128-bit basic UUID type that allows comparison and sorting.
     // Use .str() for printing and .pretty() for pretty printing.
     // Also, ostream friendly.
-    struct uuid
+    struct SOLE_UUID_ALIGN uuid
     {
         uint64_t ab;
         uint64_t cd;
 
-        bool operator==( const uuid &other ) const;
-        bool operator!=( const uuid &other ) const;
-        bool operator <( const uuid &other ) const;
+        constexpr bool operator==( const uuid &other ) const;
+        constexpr bool operator!=( const uuid &other ) const;
+        constexpr bool operator <( const uuid &other ) const; // branchless; memcmp order of to_bytes()
 
-        std::string pretty() const;
-        std::string base62() const;
+        std::string pretty( bool utc = false ) const; // utc: ISO 8601 UTC timestamps, no locale or time zone lookups
+        std::string base62( bool fixed = false ) const; // fixed: zero-padded, sorts like operator<
         std::string str() const;
 
+        // Allocation-free formatting into caller buffers. No terminating NUL is written;
+        // returns pointer past last written char.
+        enum { str_size = 36, base62_max_size = 23 };
+        char *write_str( char *out, bool upper = false ) const; // writes str_size chars
+        char *write_base62( char *out, bool fixed = false ) const; // writes up to base62_max_size chars
+
         template<typename ostream>
         inline friend ostream &operator<<( ostream &os, const uuid &self ) {
-            return os << self.str(), os;
+            char buf[ str_size + 1 ];
+            *self.write_str( buf ) = '\0';
+            return os << buf, os;
         }
     };
 
@@ -89,12 +109,391 @@ namespace sole
     uuid uuid0(); // UUID v0, pro: unique; cons: MAC revealed, pid revealed, predictable.
     uuid uuid1(); // UUID v1, pro: unique; cons: MAC revealed, predictable.
     uuid uuid4(); // UUID v4, pros: anonymous, fast; con: uuids "can clash"
+    uuid uuid6(); // UUID v6, same as v1 with time fields reordered so ids sort by creation time
+    uuid uuid7(); // UUID v7, pros: time-ordered, anonymous; con: creation time revealed
+
+    // Batch generators. Fill `n` UUIDs at once; v0/v1 share one timestamp reservation.
+    void uuid0_n( uuid *out, size_t n );
+    void uuid1_n( uuid *out, size_t n );
+    void uuid4_n( uuid *out, size_t n );
+    void uuid6_n( uuid *out, size_t n );
+    void uuid7_n( uuid *out, size_t n );
+    std::vector<uuid> uuid0_n( size_t n );
+    std::vector<uuid> uuid1_n( size_t n );
+    std::vector<uuid> uuid4_n( size_t n );
+    std::vector<uuid> uuid6_n( size_t n );
+    std::vector<uuid> uuid7_n( size_t n );
+
+    // Name-based UUIDs: MD5 (v3) or SHA-1 (v5) of namespace id and name. Deterministic.
+    uuid uuid3( const uuid &ns, const std::string &name );
+    uuid uuid5( const uuid &ns, const std::string &name );
+    uuid uuid3( const uuid &ns, const char *name, size_t len );
+    uuid uuid5( const uuid &ns, const char *name, size_t len );
+
+    // Batch name-based generators. Names up to 39 bytes fit one hash block and are
+    // hashed four at a time with SSE2 (v5 uses SHA-NI instead where available).
+    void uuid3_n( const uuid &ns, const std::string *names, size_t n, uuid *out );
+    void uuid5_n( const uuid &ns, const std::string *names, size_t n, uuid *out );
+    std::vector<uuid> uuid3_n( const uuid &ns, const std::vector<std::string> &names );
+    std::vector<uuid> uuid5_n( const uuid &ns, const std::vector<std::string> &names );
+
+    // Predefined namespace ids for uuid3/uuid5 (RFC 9562 appendix C).
+    constexpr uuid ns_dns  = { 0x6ba7b8109dad11d1ULL, 0x80b400c04fd430c8ULL };
+    constexpr uuid ns_url  = { 0x6ba7b8119dad11d1ULL, 0x80b400c04fd430c8ULL };
+    constexpr uuid ns_oid  = { 0x6ba7b8129dad11d1ULL, 0x80b400c04fd430c8ULL };
+    constexpr uuid ns_x500 = { 0x6ba7b8149dad11d1ULL, 0x80b400c04fd430c8ULL };
+
+    // Lossless in-place v1 <-> v6 conversion. Ids of any other version are left untouched.
+    void v1_to_v6( uuid *ids, size_t n );
+    void v6_to_v1( uuid *ids, size_t n );
+
+    // Node identity used by v0/v1. Resolved once and cached; refreshed after fork().
+    void set_node( uint64_t mac48 );          // pin node id (e.g. a random multicast node)
+    void reset_node();                        // forget pinned/cached node, resolve again
+    void set_node_refresh( unsigned seconds ); // re-resolve cached node periodically (0 = never)
+
+    // Clock sequence used by v1. Random per process unless restored from storage.
+    uint16_t get_clock_seq();
+    void set_clock_seq( uint16_t seq );
+
+    // Timestamp allocator counters.
+    struct clock_counters {
+        uint64_t regressions; // times the system clock was seen going backwards
+        uint64_t saturations; // times the clock had not advanced and ticks were borrowed
+    };
+    clock_counters get_clock_counters();
+
+    // Clock read for v0/v1/v6/v7 timestamps. Every source feeds the same tick allocator, so
+    // v0/v1/v6 ids stay unique and increasing whatever the source, switches included.
+    enum clock_source {
+        clock_realtime, // CLOCK_REALTIME on every id (default)
+        clock_coarse,   // CLOCK_REALTIME_COARSE plus a per-thread sub-tick counter
+        clock_tsc       // invariant TSC scaled to realtime, slewed back every 100 ms
+    };
+    void set_clock_source( clock_source src ); // falls back to clock_realtime where unsupported
+    clock_source get_clock_source();
+    int64_t clock_drift();                     // current source minus CLOCK_REALTIME, 100ns units
+
+    // Instrumentation, totals since process start (a forked child starts from its
+    // parent's). Define SOLE_ENABLE_STATS to count per thread, else those fields read 0;
+    // clock regressions and saturations are always counted. Define SOLE_USDT to also fire
+    // a USDT probe sole:<event>(amount) per event for perf/bpftrace.
+    struct stats_snapshot {
+        uint64_t generated[8];      // ids made, by version (v2 unused)
+        uint64_t clock_regressions; // system clock seen going backwards
+        uint64_t clock_saturations; // clock had not advanced and ticks were borrowed
+        uint64_t clock_spins;       // CAS retries on the shared timestamp (contention)
+        uint64_t node_lookups;      // network interface walks for a MAC address
+        uint64_t node_failures;     // walks that found none
+        uint64_t entropy_reads;     // 64-bit reads from the OS entropy source
+        uint64_t rng_refills;       // ChaCha20 keystream refills
+        uint64_t random_bytes;      // random bytes drawn by generators
+        uint64_t parse_failures;    // input rejected by parse(), rebuild() or decode_lines()
+    };
+    stats_snapshot stats();
+
+    // Fields of a uuid, decoded without allocating. Fields a version does not carry are 0.
+    struct uuid_info {
+        unsigned version;          // 4-bit version field
+        unsigned variant;          // 0: NCS, 1: RFC 4122/9562, 2: Microsoft, 3: reserved (v0 keeps pid bits there)
+        uint64_t timestamp;        // v0/v1/v6/v7: 100ns units since Unix epoch
+        uint64_t node;             // v0/v1/v6: 48-bit MAC
+        unsigned clock_seq;        // v1/v6
+        unsigned pid;              // v0
+        uint64_t bits_hi, bits_lo; // v4/v7 random bits, v3/v5 hash bits; version and variant cleared
+    };
+    uuid_info decode( const uuid &u );
+    void decode_n( const uuid *ids, size_t n, uuid_info *out );
+
+    // Bulk field extraction into one array per field, same rules as decode(). Fields a
+    // version does not carry come out 0.
+    void extract_versions( const uuid *ids, size_t n, uint8_t *out );
+    void extract_timestamps( const uuid *ids, size_t n, uint64_t *out ); // v0/v1/v6/v7, 100ns since Unix epoch
+    void extract_nodes( const uuid *ids, size_t n, uint64_t *out );      // v0/v1/v6
+    void extract_sequences( const uuid *ids, size_t n, uint16_t *out );  // v0 pid, v1/v6 clock_seq
+
+    // Sparse index over ids in creation order (non-decreasing timestamps: ids as generated,
+    // or v6/v7 ids after sort()). Keeps the timestamp of every `stride`-th id; a query
+    // decodes about 2 * log2(stride) ids. The ids are not copied and must outlive the index.
+    class time_index {
+    public:
+        time_index( const uuid *ids, size_t n, size_t stride = 256 );
+        bool ok() const { return valid; } // false if sampled timestamps go backwards
+        std::pair<size_t, size_t> range( uint64_t t0, uint64_t t1 ) const; // [first, last) of ids created in [t0, t1)
+        size_t lower_bound( uint64_t t ) const; // first id created at or after t
+        size_t memory_usage() const { return sizeof(*this) + marks.capacity() * sizeof(uint64_t); }
+
+    protected:
+        const uuid *ids;
+        size_t n, stride;
+        std::vector<uint64_t> marks; // timestamp of ids[k * stride]
+        bool valid;
+    };
 
     // Rebuilders
     uuid rebuild( uint64_t ab, uint64_t cd );
-    uuid rebuild( const std::string &uustr );
+    uuid rebuild( const std::string &uustr ); // nil uuid on malformed input
+
+    // Binary forms. to_bytes() writes RFC 4122/9562 network order, whose memcmp order
+    // matches operator<. GUID bytes use the Microsoft layout (first three fields stored
+    // little-endian). Bulk overloads may convert in place (same buffer for in and out).
+    void to_bytes( const uuid &u, uint8_t out[16] );
+    uuid from_bytes( const uint8_t in[16] );
+    void to_guid_bytes( const uuid &u, uint8_t out[16] );
+    uuid from_guid_bytes( const uint8_t in[16] );
+    void to_bytes( const uuid *ids, size_t n, uint8_t *out );
+    void from_bytes( const uint8_t *in, size_t n, uuid *out );
+    void to_guid_bytes( const uuid *ids, size_t n, uint8_t *out );
+    void from_guid_bytes( const uint8_t *in, size_t n, uuid *out );
+
+    // Validating parser. Accepts dashed hex (36 chars), plain hex (32), {braced} (38),
+    // urn:uuid: prefixed (45) and base62 forms.
+    enum parse_error {
+        parse_ok = 0,
+        parse_bad_length, // not the length of any known form
+        parse_bad_format, // separators, braces or prefix misplaced
+        parse_bad_char,   // invalid hex or base62 digit
+        parse_overflow    // base62 half does not fit in 64 bits
+    };
+    parse_error parse( const char *text, size_t len, uuid &out );
+
+    // Compile-time literals: "f81d4fae-7dec-11d0-a765-00a0c91e6bf6"_uuid. Dashed, plain and
+    // {braced} hex forms. Malformed literals fail to compile when used in constant expressions.
+    inline namespace literals {
+        constexpr uuid operator"" _uuid( const char *text, size_t len );
+    }
+
+    // Bulk text codec, one uuid per line. Work is split by chunks over `threads` threads.
+    struct lines_result {
+        size_t count;      // uuids decoded and appended
+        size_t lines;      // lines read, blank ones included
+        size_t bad_line;   // 0-based index of first malformed line, or size_t(-1)
+        parse_error error; // why bad_line was rejected
+    };
+    size_t encode_lines( const uuid *ids, size_t n, char *out, unsigned threads = 1 ); // writes n * (str_size + 1) bytes
+    lines_result decode_lines( const char *buf, size_t len, std::vector<uuid> &out, unsigned threads = 1 );
+
+    // Binary column codec for archived ids. Ids are cut into blocks of column_block;
+    // blocks of v0/v1/v6 ids are split into a timestamp stream (zigzag varint deltas) and
+    // pid/clock_seq and node streams (one value when constant). Other blocks are stored raw.
+    enum { column_block = 1024 };
+
+    class column_encoder {
+    public:
+        void push( const uuid *ids, size_t n ); // encodes every completed block
+        void finish();                          // encodes the pending partial block, if any
+        const std::vector<uint8_t> &bytes() const { return out; }
+        void clear() { out.clear(), pending.clear(); }
+
+    protected:
+        std::vector<uint8_t> out;
+        std::vector<uuid> pending;
+        void encode_block( const uuid *ids, size_t n );
+    };
+
+    class column_decoder {
+    public:
+        column_decoder( const uint8_t *data, size_t len ); // indexes block headers only
+        bool ok() const { return valid; }                  // false on truncated/corrupt headers
+        size_t size() const { return starts.empty() ? 0 : size_t( starts.back() ); }
+        size_t blocks() const { return offsets.size(); }
+        size_t block_of( size_t i ) const;                 // block holding the i-th id
+        size_t decode_block( size_t block, uuid *out ) const; // ids written, 0 on corrupt block
+        bool decode( std::vector<uuid> &out ) const;       // appends all ids, or leaves out untouched on false
+        uuid at( size_t i ) const;                         // nil uuid if out of range or corrupt
+
+    protected:
+        const uint8_t *data;
+        std::vector<size_t> offsets;   // block start in data
+        std::vector<uint64_t> starts;  // ids before each block, plus total
+        bool valid;
+    };
+
+    // Radix sorts, same order as operator<. sort() needs a buffer of n ids: it returns early
+    // on sorted input, runs LSD passes over the bytes that vary (time-ordered ids) or else
+    // an MSD sort. sort_inplace() (American flag) needs no extra memory, sort_parallel()
+    // sorts the 256 first-pass buckets concurrently.
+    void sort( uuid *first, uuid *last );
+    void sort_inplace( uuid *first, uuid *last );
+    void sort_parallel( uuid *first, uuid *last, unsigned threads = 0 ); // 0 = all cores
+
+    // Pre-generated ids. A background thread keeps a lock-free ring per enabled version
+    // topped up above a low-water mark, so take() costs one pop and first-use costs
+    // (entropy source, MAC lookup) are paid off the request path. An empty ring falls
+    // back to generating inline. Ids are stamped when generated, not when taken, so v1/v6/v7
+    // ids from a pool are unique but not ordered. A forked child drops inherited ids and
+    // starts its own refill thread.
+    class pool {
+    public:
+        struct counters {
+            size_t fill;      // ids ready now
+            uint64_t hits;    // take() calls served from the ring
+            uint64_t misses;  // take() calls generated inline
+            uint64_t refills; // ids generated by the refill thread
+        };
+
+        // versions: bitmask of 1u << v for v in 0, 1, 4, 6, 7. capacity is rounded up to a
+        // power of two; low_water 0 means half of it.
+        explicit pool( unsigned versions = 1u << 4, size_t capacity = 4096, size_t low_water = 0 );
+        ~pool();
+        pool( const pool & ) = delete;
+        pool &operator=( const pool & ) = delete;
+
+        uuid take( unsigned version = 4 ); // versions not enabled are generated inline
+        counters stats( unsigned version = 4 ) const;
+
+    protected:
+        struct state;
+        state *self;
+    };
+
+    // Reproducible ids for fixtures and replayable load tests: random bits come from
+    // xoshiro256** seeded through splitmix64, timestamps from a virtual clock that moves
+    // `step` ticks (100ns) per time-based id, node and clock_seq from the seed. The same
+    // seed and calls give byte-identical streams on every platform. Not cryptographic,
+    // not thread-safe: give each thread its own copy and call jump() i times on the i-th.
+    class deterministic_generator {
+    public:
+        explicit deterministic_generator( uint64_t seed, uint64_t start = 0, uint64_t step = 1 ); // start: 100ns since Unix epoch
+
+        uuid uuid0();
+        uuid uuid1();
+        uuid uuid4();
+        uuid uuid6();
+        uuid uuid7();
+        void uuid4_n( uuid *out, size_t n );
+
+        // Skips 2^128 draws and redraws node and clock_seq, so copies jumped a different
+        // number of times never overlap.
+        void jump();
+
+        uint64_t now() const { return clock; }
+        void set_time( uint64_t ticks ) { clock = ticks; }
+        void set_node( uint64_t mac48 ) { node = mac48 & 0xFFFFFFFFFFFFULL; }
+        void set_pid( uint16_t value ) { pid = value; }
+        void set_clock_seq( uint16_t seq ) { clock_seq = seq & 0x3fff; }
+        uint64_t next(); // raw xoshiro256** output
+
+    protected:
+        uint64_t s[4];
+        uint64_t clock, step, node, v7_ms, v7_counter;
+        uint16_t pid, clock_seq;
+        uint64_t tick();
+        void redraw_identity();
+    };
+
+    // 64x64->128 multiply, folded back to 64 bits (wyhash's "mum").
+    inline uint64_t mum( uint64_t a, uint64_t b ) {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = (__uint128_t)a * b;
+        return uint64_t( r ) ^ uint64_t( r >> 64 );
+#else
+        uint64_t ha = a >> 32, la = uint32_t( a ), hb = b >> 32, lb = uint32_t( b );
+        uint64_t ll = la * lb, lh = la * hb, hl = ha * lb, hh = ha * hb;
+        uint64_t mid = ( ll >> 32 ) + uint32_t( lh ) + uint32_t( hl );
+        uint64_t lo = ( mid << 32 ) | uint32_t( ll );
+        uint64_t hi = hh + ( lh >> 32 ) + ( hl >> 32 ) + ( mid >> 32 );
+        return lo ^ hi;
+#endif
+    }
+
+    inline size_t fold_hash( uint64_t h ) {
+        return sizeof(size_t) > 4 ? size_t( h ) : size_t( uint32_t( h >> 32 ) ^ uint32_t( h ) );
+    }
+
+    // Hash policies. Any of them can be given to unordered containers; std::hash<uuid>
+    // uses SOLE_HASH_POLICY (mix_hash unless defined otherwise).
+    struct xor_hash {   // legacy ab ^ cd: fast, but clusters v0/v1 keys
+        size_t operator()( const uuid &u ) const {
+            return fold_hash( u.ab ^ u.cd );
+        }
+    };
+
+    struct mix_hash {   // every input bit affects every output bit; two multiplies
+        size_t operator()( const uuid &u ) const {
+            return fold_hash( mum( mum( u.ab ^ 0xa0761d6478bd642fULL, u.cd ^ 0xe7037ed1a0b428dbULL ) ^ 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL ) );
+        }
+    };
+
+    struct keyed_hash { // seeded mix_hash against hash flooding with client-supplied ids
+        uint64_t k0, k1;
+        keyed_hash();                        // random per-process key
+        explicit keyed_hash( uint64_t seed );
+        size_t operator()( const uuid &u ) const {
+            return fold_hash( mum( mum( u.ab ^ k0, u.cd ^ k1 ) ^ 0x8ebc6af09c88c6e3ULL, k1 ^ 0x589965cc75374cc3ULL ) );
+        }
+    };
+
+    // Flat hash containers for uuid keys: open addressing over one slot array plus one
+    // control byte per slot, probed 16 slots at a time (Swiss table layout).
+    template<typename V>
+    struct uuid_slot {
+        uuid key;
+        V value;
+    };
+    template<>
+    struct uuid_slot<void> {
+        uuid key;
+    };
+
+    template<typename V, typename HASH = mix_hash>
+    class uuid_table {
+    public:
+        explicit uuid_table( size_t reserve_for = 0 );
+
+        size_t size() const { return count; }
+        bool empty() const { return !count; }
+        size_t capacity() const { return slots.size(); }
+        size_t memory_usage() const; // bytes owned, table object included
+
+        void reserve( size_t n );
+        void clear();
+        bool contains( const uuid &key ) const { return find_index( key ) != npos; }
+        bool erase( const uuid &key );
+
+        template<typename FN>
+        void for_each( const FN &fn ) const {
+            for( size_t i = 0; i < slots.size(); ++i ) if( ctrl[i] >= 0 ) fn( slots[i] );
+        }
+
+    protected:
+        enum : signed char { ctrl_empty = -128, ctrl_deleted = -2 }; // full slots hold 7 hash bits
+        enum : size_t { group = 16, npos = ~size_t(0) };
+
+        std::vector<signed char> ctrl;
+        std::vector< uuid_slot<V> > slots;
+        size_t count = 0, growth_left = 0;
+        HASH hash;
+
+        size_t find_index( const uuid &key ) const;
+        std::pair<size_t, bool> insert_key( const uuid &key ); // slot index, inserted
+        size_t free_index( size_t h ) const;                   // first empty or deleted slot
+        void rehash( size_t slots_wanted );
+        unsigned match( size_t at, signed char tag ) const;    // bitmask of group slots == tag
+        unsigned match_free( size_t at ) const;                // bitmask of empty or deleted
+    };
+
+    class uuid_set : public uuid_table<void> {
+    public:
+        using uuid_table<void>::uuid_table;
+        bool insert( const uuid &key ) { return insert_key( key ).second; }
+    };
+
+    template<typename V>
+    class uuid_map : public uuid_table<V> {
+    public:
+        using uuid_table<V>::uuid_table;
+        V *find( const uuid &key );
+        const V *find( const uuid &key ) const;
+        V &operator[]( const uuid &key ) { return this->slots[ this->insert_key( key ).first ].value; }
+        bool insert( const uuid &key, const V &value ); // false (and no overwrite) if present
+    };
 }
 
+#ifndef SOLE_HASH_POLICY
+#define SOLE_HASH_POLICY sole::mix_hash
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(push)
 #pragma warning(disable:4127)
@@ -102,17 +501,7 @@ namespace sole
 
 namespace std {
     template<>
-    struct hash< sole::uuid > {
-    public:
-        // hash functor: hash uuid to size_t value by pseudorandomizing transform
-        size_t operator()( const sole::uuid &uuid ) const {
-            if( sizeof(size_t) > 4 ) {
-                return size_t( uuid.ab ^ uuid.cd );
-            } else {
-                uint64_t hash64 = uuid.ab ^ uuid.cd;
-                return size_t( uint32_t( hash64 >> 32 ) ^ uint32_t( hash64 ) );
-            }
-        }
+    struct hash< sole::uuid > : SOLE_HASH_POLICY {
     };
 }
 
@@ -130,10 +519,16 @@ namespace std {
 #include <cstring>
 #include <ctime>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #if defined(_WIN32)
@@ -198,10 +593,63 @@ namespace std {
 #   define $unix $yes
 #endif
 
+#if !defined(_WIN32)
+#   include <pthread.h>
+#endif
+
+// SIMD kernels. Define SOLE_NO_SIMD to force the portable scalar paths.
+#if !defined(SOLE_NO_SIMD)
+#   if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define SOLE_SSE2 1
+#       include <emmintrin.h>
+#   endif
+#   if defined(__SSSE3__) || defined(__AVX__)
+#       define SOLE_SSSE3 1
+#       include <tmmintrin.h>
+#   endif
+#   if defined(__AVX2__)
+#       define SOLE_AVX2 1
+#       include <immintrin.h>
+#   endif
+#   if defined(__SHA__) && defined(__SSE4_1__)
+#       define SOLE_SHA 1
+#       include <immintrin.h>
+#   endif
+#endif
+
 #ifdef _MSC_VER
+#   include <intrin.h>
 #   define $msvc  $yes
 #endif
 
+// Time stamp counter, for the clock_tsc source.
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#   define SOLE_TSC 1
+#   ifndef _MSC_VER
+#       include <cpuid.h>
+#       include <x86intrin.h>
+#   endif
+#endif
+
+// Default clock source, see sole::set_clock_source().
+#ifndef SOLE_CLOCK_SOURCE
+#define SOLE_CLOCK_SOURCE sole::clock_realtime
+#endif
+
+// Instrumentation hooks. Both compile to nothing unless enabled.
+#if defined(SOLE_USDT) && defined(__linux__)
+#   include <sys/sdt.h>
+#   define SOLE_PROBE(name, n) DTRACE_PROBE1( sole, name, uint64_t( n ) )
+#else
+#   define SOLE_PROBE(name, n)
+#endif
+#ifdef SOLE_ENABLE_STATS
+#   define SOLE_STAT(name, n) sole::stat_add( sole::stat_##name, uint64_t( n ) )
+#else
+#   define SOLE_STAT(name, n)
+#endif
+#define SOLE_EVENT(name, n) do { SOLE_STAT(name, n); SOLE_PROBE(name, n); } while( 0 )
+
 #ifdef _MSC_VER
 #   define $thread __declspec(thread)
 #elif defined __clang__
@@ -275,21 +723,48 @@ namespace std {
 #define $yes(...) __VA_ARGS__
 #define $no(...)
 
-inline bool sole::uuid::operator==( const sole::uuid &other ) const {
+constexpr bool sole::uuid::operator==( const sole::uuid &other ) const {
     return ab == other.ab && cd == other.cd;
 }
-inline bool sole::uuid::operator!=( const sole::uuid &other ) const {
+constexpr bool sole::uuid::operator!=( const sole::uuid &other ) const {
     return !operator==(other);
 }
-inline bool sole::uuid::operator<( const sole::uuid &other ) const {
-    if( ab < other.ab ) return true;
-    if( ab > other.ab ) return false;
-    if( cd < other.cd ) return true;
-    return false;
+constexpr bool sole::uuid::operator<( const sole::uuid &other ) const {
+    return ( ab < other.ab ) | ( ( ab == other.ab ) & ( cd < other.cd ) );
 }
 
 namespace sole {
 
+    inline uint64_t bswap64( uint64_t v ) {
+        $msvc( return _byteswap_uint64( v ); )
+        $melse( return __builtin_bswap64( v ); )
+    }
+
+    // Count trailing zeros, v != 0
+    inline unsigned ctz32( unsigned v ) {
+        $msvc( unsigned long i; _BitScanForward( &i, v ); return unsigned( i ); )
+        $melse( return unsigned( __builtin_ctz( v ) ); )
+    }
+
+    // Equality as one 128-bit vector compare when uuids are known to be 16-byte aligned.
+    inline bool same_uuid( const uuid &a, const uuid &b ) {
+#if SOLE_SSE2 && defined(SOLE_ALIGN16)
+        __m128i eq = _mm_cmpeq_epi8( _mm_load_si128( (const __m128i *)&a ), _mm_load_si128( (const __m128i *)&b ) );
+        return _mm_movemask_epi8( eq ) == 0xFFFF;
+#else
+        return a == b;
+#endif
+    }
+
+    // User locale for printftime(), resolved once: std::locale("") parses the environment.
+    inline const std::locale &pretty_locale() {
+        static const std::locale lc = []() {
+            try { return std::locale( "" ); }
+            catch(...) { return std::locale::classic(); }
+        }();
+        return lc;
+    }
+
     inline std::string printftime( uint64_t timestamp_secs = 0, const std::string &locale = std::string() ) {
         std::string timef;
         try {
@@ -307,8 +782,7 @@ namespace sole {
 
             std::stringstream ss;
             $melse(
-            std::locale lc( locale.c_str() );
-            ss.imbue( lc );
+            ss.imbue( locale.empty() ? pretty_locale() : std::locale( locale.c_str() ) );
             )
             ss << std::put_time( &tm, "\"%c\"" );
 
@@ -320,79 +794,275 @@ namespace sole {
         return timef;
     }
 
-    inline std::string uuid::pretty() const {
-        std::stringstream ss;
+    // Writes v in decimal, zero-padded to at least `width` digits. Returns end.
+    inline char *write_dec( char *out, uint64_t v, int width ) {
+        char tmp[20];
+        int n = 0;
+        do tmp[n++] = char( '0' + v % 10 ); while( v /= 10 );
+        while( n < width ) tmp[n++] = '0';
+        while( n ) *out++ = tmp[--n];
+        return out;
+    }
 
-        uint64_t a = (ab >> 32);
-        uint64_t b = (ab & 0xFFFFFFFF);
-        uint64_t c = (cd >> 32);
-        uint64_t d = (cd & 0xFFFFFFFF);
+    // Writes v in lowercase hex, zero-padded to at least `width` digits. Returns end.
+    inline char *write_hex( char *out, uint64_t v, int width ) {
+        char tmp[16];
+        int n = 0;
+        do tmp[n++] = "0123456789abcdef"[v & 15]; while( v >>= 4 );
+        while( n < width ) tmp[n++] = '0';
+        while( n ) *out++ = tmp[--n];
+        return out;
+    }
 
-        int version = (b & 0xF000) >> 12;
-        uint64_t timestamp = ((b & 0x0FFF) << 48 ) | (( b >> 16 ) << 32) | a; // in 100ns units
+    // "YYYY-MM-DDTHH:MM:SS.fffffffZ" from 100ns units since Unix epoch. Returns end.
+    inline char *write_iso8601( char *out, uint64_t ns100 ) {
+        const uint64_t per_day = 864000000000ULL;
+        uint64_t days = ns100 / per_day, ticks = ns100 % per_day;
+        // days to civil date (H. Hinnant's algorithm), proleptic Gregorian calendar
+        uint64_t z = days + 719468, era = z / 146097, doe = z - era * 146097;
+        uint64_t yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+        uint64_t doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 ), mp = ( 5 * doy + 2 ) / 153;
+        uint64_t day = doy - ( 153 * mp + 2 ) / 5 + 1, month = mp < 10 ? mp + 3 : mp - 9;
+        uint64_t year = yoe + era * 400 + ( month <= 2 );
+
+        out = write_dec( out, year, 4 ), *out++ = '-';
+        out = write_dec( out, month, 2 ), *out++ = '-';
+        out = write_dec( out, day, 2 ), *out++ = 'T';
+        out = write_dec( out, ticks / 36000000000ULL, 2 ), *out++ = ':';
+        out = write_dec( out, ticks / 600000000 % 60, 2 ), *out++ = ':';
+        out = write_dec( out, ticks / 10000000 % 60, 2 ), *out++ = '.';
+        out = write_dec( out, ticks % 10000000, 7 ), *out++ = 'Z';
+        return out;
+    }
 
-        ss << "version=" << (version) << ',';
+    inline uuid_info decode( const uuid &u ) {
+        uuid_info i = {};
+        i.version = unsigned( ( u.ab >> 12 ) & 0xF );
+        unsigned top = unsigned( u.cd >> 61 );
+        i.variant = top < 4 ? 0 : top < 6 ? 1 : top < 7 ? 2 : 3;
+
+        switch( i.version ) {
+            case 1: case 6:
+                i.timestamp = ( i.version == 6 ? ( ( u.ab >> 16 ) << 12 ) | ( u.ab & 0x0FFF )
+                                               : ( ( u.ab & 0x0FFF ) << 48 ) | ( ( ( u.ab >> 16 ) & 0xFFFF ) << 32 ) | ( u.ab >> 32 ) )
+                            - 0x01b21dd213814000ULL; // Gregorian to Unix epoch
+                i.clock_seq = unsigned( ( u.cd >> 48 ) & 0x3FFF );
+                i.node = u.cd & 0xFFFFFFFFFFFFULL;
+                break;
+            case 0:
+                i.timestamp = ( ( u.ab & 0x0FFF ) << 48 ) | ( ( ( u.ab >> 16 ) & 0xFFFF ) << 32 ) | ( u.ab >> 32 );
+                i.pid = unsigned( u.cd >> 48 );
+                i.node = u.cd & 0xFFFFFFFFFFFFULL;
+                break;
+            case 7:
+                i.timestamp = ( u.ab >> 16 ) * 10000;
+                i.bits_hi = u.ab & 0x0FFF;
+                i.bits_lo = u.cd & 0x3FFFFFFFFFFFFFFFULL;
+                break;
+            case 3: case 4: case 5:
+                i.bits_hi = u.ab & 0xFFFFFFFFFFFF0FFFULL;
+                i.bits_lo = u.cd & 0x3FFFFFFFFFFFFFFFULL;
+                break;
+        }
+        return i;
+    }
 
-        if( version == 1 )
-            timestamp = timestamp - 0x01b21dd213814000ULL; // decrement Gregorian calendar
+    inline void decode_n( const uuid *ids, size_t n, uuid_info *out ) {
+        for( size_t i = 0; i < n; ++i ) out[i] = decode( ids[i] );
+    }
 
-        ss << std::hex << std::nouppercase << std::setfill('0');
-        version <= 1 && ss << "timestamp=" << printftime(timestamp/10000000) << ',';
-        version <= 1 && ss << "mac=" << std::setw(4) << (c & 0xFFFF) << std::setw(8) << d << ',';
-        version == 4 && ss << "randbits=" << std::setw(8) << (ab & 0xFFFFFFFFFFFF0FFFULL) << std::setw(8) << (cd & 0x3FFFFFFFFFFFFFFFULL) << ',';
+    // Branch-free decode() of single fields: every layout is computed and the right one
+    // selected, so the bulk loops below compile to straight-line (vectorizable) code.
+    inline uint64_t all_if( bool c ) { // all ones if c, else 0
+        return 0 - uint64_t( c );
+    }
 
-        ss << std::dec;
-        version == 0 && ss << "pid=" << std::setw(4) << (c >> 16 ) << ',';
-        version == 1 && ss << "clock_seq=" << std::setw(4) << ((c >> 16) & 0x3FFF) << ',';
+    inline unsigned version_of( const uuid &u ) {
+        return unsigned( ( u.ab >> 12 ) & 0xF );
+    }
 
-        return ss.str();
+    inline uint64_t timestamp_of( const uuid &u ) {
+        uint64_t ab = u.ab, v = ( ab >> 12 ) & 0xF;
+        uint64_t t1 = ( ( ab & 0x0FFF ) << 48 ) | ( ( ( ab >> 16 ) & 0xFFFF ) << 32 ) | ( ab >> 32 );
+        uint64_t t6 = ( ( ab >> 16 ) << 12 ) | ( ab & 0x0FFF );
+        uint64_t t7 = ( ab >> 16 ) * 10000, greg = 0x01b21dd213814000ULL; // Gregorian to Unix epoch
+        return ( t1 & all_if( v == 0 ) ) | ( ( t1 - greg ) & all_if( v == 1 ) )
+             | ( ( t6 - greg ) & all_if( v == 6 ) ) | ( t7 & all_if( v == 7 ) );
     }
 
-    inline std::string uuid::str() const {
-        char uustr[] = "00000000-0000-0000-0000-000000000000";
-        constexpr char encode[] = "0123456789abcdef";
+    inline uint64_t node_of( const uuid &u ) {
+        uint64_t v = ( u.ab >> 12 ) & 0xF;
+        return ( u.cd & 0xFFFFFFFFFFFFULL ) & all_if( v <= 1 || v == 6 );
+    }
 
-        size_t bit = 15;
-        for( size_t i = 0; i < 18; i++ ) {
-            if( i == 8 || i == 13 ) {
-                continue;
-            }
-            uustr[i] = encode[ab>>4*bit&0x0f];
-            bit--;
+    inline uint16_t sequence_of( const uuid &u ) {
+        uint64_t v = ( u.ab >> 12 ) & 0xF, hi = u.cd >> 48;
+        return uint16_t( ( hi & all_if( v == 0 ) ) | ( hi & 0x3FFF & all_if( v == 1 || v == 6 ) ) );
+    }
+
+    inline void extract_versions( const uuid *ids, size_t n, uint8_t *out ) {
+        for( size_t i = 0; i < n; ++i ) out[i] = uint8_t( version_of( ids[i] ) );
+    }
+
+    inline void extract_timestamps( const uuid *ids, size_t n, uint64_t *out ) {
+        size_t i = 0;
+#if SOLE_SSE2
+        // two ids per step; v7 milliseconds * 10000 as shifts and adds (SSE2 has no 64-bit multiply)
+        const __m128i low12 = _mm_set1_epi64x( 0x0FFF ), low16 = _mm_set1_epi64x( 0xFFFF );
+        const __m128i greg = _mm_set1_epi64x( 0x01b21dd213814000LL ), nibble = _mm_set1_epi64x( 0xF );
+        for( ; i + 2 <= n; i += 2 ) {
+            __m128i ab = _mm_unpacklo_epi64( _mm_loadu_si128( (const __m128i *)&ids[i] ), _mm_loadu_si128( (const __m128i *)&ids[i + 1] ) );
+            __m128i v = _mm_and_si128( _mm_srli_epi64( ab, 12 ), nibble );
+            __m128i t1 = _mm_or_si128( _mm_or_si128( _mm_slli_epi64( _mm_and_si128( ab, low12 ), 48 ),
+                                                     _mm_slli_epi64( _mm_and_si128( _mm_srli_epi64( ab, 16 ), low16 ), 32 ) ),
+                                       _mm_srli_epi64( ab, 32 ) );
+            __m128i t6 = _mm_or_si128( _mm_slli_epi64( _mm_srli_epi64( ab, 16 ), 12 ), _mm_and_si128( ab, low12 ) );
+            __m128i ms = _mm_srli_epi64( ab, 16 );
+            __m128i t7 = _mm_add_epi64( _mm_add_epi64( _mm_slli_epi64( ms, 13 ), _mm_slli_epi64( ms, 10 ) ),
+                                        _mm_add_epi64( _mm_add_epi64( _mm_slli_epi64( ms, 9 ), _mm_slli_epi64( ms, 8 ) ), _mm_slli_epi64( ms, 4 ) ) );
+            // version sits in the low dword, the high one is 0: widen the low compare result
+            #define SOLE_IS(k) _mm_shuffle_epi32( _mm_cmpeq_epi32( v, _mm_set1_epi64x( k ) ), _MM_SHUFFLE( 2, 2, 0, 0 ) )
+            __m128i r = _mm_or_si128( _mm_or_si128( _mm_and_si128( SOLE_IS( 0 ), t1 ), _mm_and_si128( SOLE_IS( 1 ), _mm_sub_epi64( t1, greg ) ) ),
+                                      _mm_or_si128( _mm_and_si128( SOLE_IS( 6 ), _mm_sub_epi64( t6, greg ) ), _mm_and_si128( SOLE_IS( 7 ), t7 ) ) );
+            #undef SOLE_IS
+            _mm_storeu_si128( (__m128i *)&out[i], r );
         }
+#endif
+        for( ; i < n; ++i ) out[i] = timestamp_of( ids[i] );
+    }
 
-        bit = 15;
-        for( size_t i = 18; i < 36; i++ ) {
-            if( i == 18 || i == 23 ) {
-                continue;
-            }
-            uustr[i] = encode[cd>>4*bit&0x0f];
-            bit--;
+    inline void extract_nodes( const uuid *ids, size_t n, uint64_t *out ) {
+        for( size_t i = 0; i < n; ++i ) out[i] = node_of( ids[i] );
+    }
+
+    inline void extract_sequences( const uuid *ids, size_t n, uint16_t *out ) {
+        for( size_t i = 0; i < n; ++i ) out[i] = sequence_of( ids[i] );
+    }
+
+    inline std::string uuid::pretty( bool utc ) const {
+        uuid_info i = decode( *this );
+        bool timed = i.version <= 1 || i.version == 6;
+        char buf[128], *p = buf;
+        std::string s;
+
+        p = write_dec( std::strcpy( p, "version=" ) + 8, i.version, 1 ), *p++ = ',';
+        if( timed || i.version == 7 ) {
+            p = std::strcpy( p, "timestamp=" ) + 10;
+            if( utc ) p = write_iso8601( p, i.timestamp );
+            else s.assign( buf, p ), s += printftime( i.timestamp / 10000000 ), p = buf;
+            *p++ = ',';
+        }
+        if( timed ) p = write_hex( std::strcpy( p, "mac=" ) + 4, i.node, 12 ), *p++ = ',';
+        if( i.version == 4 ) {
+            p = write_hex( std::strcpy( p, "randbits=" ) + 9, i.bits_hi, 8 );
+            p = write_hex( p, i.bits_lo, 8 ), *p++ = ',';
+        }
+        if( i.version == 3 || i.version == 5 ) {
+            p = write_hex( std::strcpy( p, "hash=" ) + 5, i.bits_hi, 16 );
+            p = write_hex( p, i.bits_lo, 16 ), *p++ = ',';
+        }
+        if( i.version == 7 ) {
+            p = write_hex( std::strcpy( p, "randbits=" ) + 9, i.bits_hi, 3 );
+            p = write_hex( p, i.bits_lo, 16 ), *p++ = ',';
         }
+        if( i.version == 0 ) p = write_dec( std::strcpy( p, "pid=" ) + 4, i.pid, 4 ), *p++ = ',';
+        if( i.version == 1 || i.version == 6 ) p = write_dec( std::strcpy( p, "clock_seq=" ) + 10, i.clock_seq, 4 ), *p++ = ',';
 
-        return std::string(uustr);
+        return s.append( buf, p );
     }
 
-    inline std::string uuid::base62() const {
-        int base62len = 10 + 26 + 26;
+    // Encodes 16 bytes (big-endian ab, cd) as 32 hex digits.
+    inline void encode_hex32( uint64_t ab, uint64_t cd, char *hex, bool upper ) {
+#if SOLE_SSE2
+        // split every byte into nibbles and interleave them in text order
+        __m128i bytes = _mm_set_epi64x( (long long)bswap64( cd ), (long long)bswap64( ab ) );
+        const __m128i nib = _mm_set1_epi8( 0x0F );
+        __m128i hi = _mm_and_si128( _mm_srli_epi16( bytes, 4 ), nib );
+        __m128i lo = _mm_and_si128( bytes, nib );
+        __m128i n0 = _mm_unpacklo_epi8( hi, lo ), n1 = _mm_unpackhi_epi8( hi, lo );
+#   if SOLE_SSSE3
+        // pshufb nibble lookup
+        const __m128i lut = upper ? _mm_setr_epi8( '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F' )
+                                  : _mm_setr_epi8( '0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f' );
+        n0 = _mm_shuffle_epi8( lut, n0 );
+        n1 = _mm_shuffle_epi8( lut, n1 );
+#   else
+        // '0' + n, plus distance to 'a' (or 'A') when n > 9
+        const __m128i nine = _mm_set1_epi8( 9 ), zero = _mm_set1_epi8( '0' ), gap = _mm_set1_epi8( upper ? 'A' - '0' - 10 : 'a' - '0' - 10 );
+        n0 = _mm_add_epi8( _mm_add_epi8( n0, zero ), _mm_and_si128( _mm_cmpgt_epi8( n0, nine ), gap ) );
+        n1 = _mm_add_epi8( _mm_add_epi8( n1, zero ), _mm_and_si128( _mm_cmpgt_epi8( n1, nine ), gap ) );
+#   endif
+        _mm_storeu_si128( (__m128i *)( hex +  0 ), n0 );
+        _mm_storeu_si128( (__m128i *)( hex + 16 ), n1 );
+#else
+        const char *encode = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        for( int i = 0; i < 16; ++i ) {
+            unsigned byte = unsigned( ( i < 8 ? ab >> ( 56 - 8 * i ) : cd >> ( 120 - 8 * i ) ) & 0xFF );
+            hex[2 * i + 0] = encode[byte >> 4];
+            hex[2 * i + 1] = encode[byte & 15];
+        }
+#endif
+    }
+
+    inline char *uuid::write_str( char *out, bool upper ) const {
+        char hex[32];
+        encode_hex32( ab, cd, hex, upper );
+
+        std::memcpy( out +  0, hex +  0, 8 ); out[ 8] = '-';
+        std::memcpy( out +  9, hex +  8, 4 ); out[13] = '-';
+        std::memcpy( out + 14, hex + 12, 4 ); out[18] = '-';
+        std::memcpy( out + 19, hex + 16, 4 ); out[23] = '-';
+        std::memcpy( out + 24, hex + 20, 12 );
+        return out + str_size;
+    }
+
+    inline std::string uuid::str() const {
+        char uustr[ str_size ];
+        return std::string( uustr, write_str( uustr ) );
+    }
+
+    // Writes 11 zero-padded base62 digits. Splits value in 62^10 and two 62^5 chunks, so
+    // the divisions are by constants (multiplications) and the per-digit ones are 32-bit.
+    inline void encode_base62_11( uint64_t v, char *out ) {
         const char base62[] =
             "0123456789"
             "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
             "abcdefghijklmnopqrstuvwxyz";
-        char res[24], *end = &res[24]; *(--end) = '\0';
-        uint64_t rem, AB = ab, CD = cd;
-        do {
-            rem = CD % base62len;
-            *--end = base62[int(rem)];
-            CD /= base62len;
-        } while (CD > 0);
-        *--end = '-';
-        do {
-            rem = AB % base62len;
-            *--end = base62[int(rem)];
-            AB /= base62len;
-        } while (AB > 0);
-        return end;
+        const uint64_t p5 = 916132832ULL, p10 = p5 * p5; // 62^5, 62^10
+
+        uint64_t hi = v / p10, rest = v - hi * p10;
+        uint64_t mid = rest / p5;
+        uint32_t chunk[2] = { uint32_t( mid ), uint32_t( rest - mid * p5 ) };
+
+        out[0] = base62[hi];
+        for( int c = 0; c < 2; ++c ) {
+            uint32_t n = chunk[c];
+            for( int i = 5; i > 0; --i ) {
+                uint32_t q = uint32_t( ( uint64_t(n) * 2216757315ULL ) >> 37 ); // n / 62, exact for n < 62^5
+                out[ 5 * c + i ] = base62[ n - q * 62 ];
+                n = q;
+            }
+        }
+    }
+
+    inline char *uuid::write_base62( char *out, bool fixed ) const {
+        char digits[2][11];
+        encode_base62_11( ab, digits[0] );
+        encode_base62_11( cd, digits[1] );
+
+        for( int h = 0; h < 2; ++h ) {
+            int skip = 0;
+            if( !fixed ) while( skip < 10 && digits[h][skip] == '0' ) ++skip; // legacy: no padding
+            std::memcpy( out, digits[h] + skip, size_t( 11 - skip ) );
+            out += 11 - skip;
+            if( !h ) *out++ = '-';
+        }
+        return out;
+    }
+
+    inline std::string uuid::base62( bool fixed ) const {
+        char res[ base62_max_size ];
+        return std::string( res, write_base62( res, fixed ) );
     }
 
     //////////////////////////////////////////////////////////////////////////////////////
@@ -471,11 +1141,97 @@ namespace sole {
         }
     )))
 
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Fork detection
+
+    // Bumped in the child process after every fork(). Per-thread and per-process caches
+    // remember the value they were built with and rebuild themselves when it changes.
+    inline std::atomic<unsigned> &fork_counter() {
+        static std::atomic<unsigned> counter( 0 );
+        return counter;
+    }
+
+    inline void reset_caches_after_fork();
+
+    inline void on_fork_child() {
+        fork_counter().fetch_add( 1, std::memory_order_relaxed );
+        reset_caches_after_fork();
+    }
+
+    // Registers the fork handler once per process. Returns current fork generation.
+    inline unsigned fork_generation() {
+        $welse(
+            static int registered = pthread_atfork( 0, 0, &on_fork_child );
+            (void)registered;
+        )
+        return fork_counter().load( std::memory_order_relaxed );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Instrumentation
+
+    enum stat_id {
+        stat_uuid0 = 0, stat_uuid1 = 1, stat_uuid3 = 3, stat_uuid4 = 4, stat_uuid5 = 5, stat_uuid6 = 6, stat_uuid7 = 7,
+        stat_clock_spin, stat_node_lookup, stat_node_failure, stat_entropy_read, stat_rng_refill, stat_random_bytes,
+        stat_parse_failure, stat_count
+    };
+
+    // Per-thread counters, padded to whole cache lines. Only the owner thread writes, with
+    // plain load + store (no locked add); stats() reads every block. Blocks are never freed:
+    // an exiting thread hands its block, counts included, to the next new thread, so memory
+    // is bounded by the peak number of threads.
+    struct stat_block {
+        char pad0[64];
+        std::atomic<uint64_t> count[ stat_count ];
+        std::atomic<bool> owned;
+        stat_block *next;
+        char pad1[64];
+    };
+
+    inline std::atomic<stat_block *> &stat_blocks() {
+        static std::atomic<stat_block *> head( nullptr );
+        return head;
+    }
+
+    inline stat_block *stat_claim() {
+        std::atomic<stat_block *> &head = stat_blocks();
+        for( stat_block *b = head.load( std::memory_order_acquire ); b; b = b->next ) {
+            bool free = false;
+            if( b->owned.compare_exchange_strong( free, true, std::memory_order_acquire ) ) return b;
+        }
+        stat_block *b = new stat_block(); // zeroed
+        b->owned.store( true, std::memory_order_relaxed );
+        b->next = head.load( std::memory_order_relaxed );
+        while( !head.compare_exchange_weak( b->next, b, std::memory_order_release, std::memory_order_relaxed ) ) {}
+        return b;
+    }
+
+    // Releases the block at thread exit. Events counted by later thread_local destructors
+    // of the same thread still land in it, and may race with its next owner (lost counts).
+    struct stat_owner {
+        stat_block *block;
+        ~stat_owner() { if( block ) block->owned.store( false, std::memory_order_release ); }
+    };
+
+    inline stat_block &stat_local() {
+        static $thread stat_block *mine = 0;
+        if( !mine ) {
+            static thread_local stat_owner owner;
+            mine = owner.block = stat_claim();
+        }
+        return *mine;
+    }
+
+    inline void stat_add( stat_id id, uint64_t n ) {
+        std::atomic<uint64_t> &c = stat_local().count[ id ];
+        c.store( c.load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////
     // Timestamp and MAC interfaces
 
-    // Returns number of 100ns intervals
-    inline uint64_t get_time( uint64_t offset ) {
+    // Reads system clock in 100ns intervals since Unix epoch
+    inline uint64_t read_realtime() {
         struct timespec tp;
         clock_gettime(0 /*CLOCK_REALTIME*/, &tp);
 
@@ -483,17 +1239,241 @@ namespace sole {
         uint64_t uuid_time;
         uuid_time = tp.tv_sec * 10000000;
         uuid_time = uuid_time + (tp.tv_nsec / 100);
+        return uuid_time;
+    }
+
+    // Coarse clock: one vDSO memory read, no time stamp counter, updated every jiffy.
+    // Each thread adds one tick per call while the coarse value stands still, stopping
+    // short of the next update, so its readings keep increasing.
+    inline uint64_t coarse_resolution() {
+#ifdef CLOCK_REALTIME_COARSE
+        struct timespec res;
+        if( clock_getres( CLOCK_REALTIME_COARSE, &res ) == 0 && !res.tv_sec && res.tv_nsec >= 100 )
+            return uint64_t( res.tv_nsec / 100 );
+#endif
+        return 0; // unsupported
+    }
+
+    inline uint64_t read_coarse() {
+#ifdef CLOCK_REALTIME_COARSE
+        static const uint64_t resolution = coarse_resolution();
+        static $thread uint64_t base = 0, sub = 0;
+        struct timespec tp;
+        clock_gettime( CLOCK_REALTIME_COARSE, &tp );
+        uint64_t now = uint64_t( tp.tv_sec ) * 10000000 + uint64_t( tp.tv_nsec / 100 );
+        if( now != base ) base = now, sub = 0;
+        else if( sub + 1 < resolution ) ++sub;
+        return base + sub;
+#else
+        return read_realtime();
+#endif
+    }
+
+    // TSC clock: ticks = base + ( tsc - tsc0 ) * mult / 2^32. The rate is measured against
+    // CLOCK_REALTIME over the whole process lifetime; every 100 ms the anchor moves to the
+    // current TSC reading and the rate is nudged (at most 500 ppm) so the remaining error
+    // is absorbed by the next resync, keeping readings continuous. Errors over 1 ms (clock
+    // stepped by NTP or by hand) are stepped instead. Parameters are published with a
+    // seqlock: readers never wait, they read CLOCK_REALTIME while a writer is busy.
+    struct tsc_clock {
+        enum : uint64_t { calibrate_ticks = 100000, resync_ticks = 1000000, step_ticks = 10000, max_ppm = 500 };
+
+        std::atomic<uint32_t> seq;                // odd while writing, 0 until calibrated
+        std::atomic<uint64_t> tsc0, base, mult;   // current anchor and rate
+        std::atomic<uint64_t> next;               // tsc of next resync
+        uint64_t first_tsc, first_ticks, first_width; // calibration point, written under the lock
+    };
+
+    inline tsc_clock &tsc_state() {
+        static tsc_clock state; // zero-initialized
+        return state;
+    }
+
+    inline bool has_invariant_tsc() {
+#if SOLE_TSC
+        $msvc(
+            int r[4];
+            __cpuid( r, int( 0x80000000 ) );
+            if( unsigned( r[0] ) < 0x80000007 ) return false;
+            __cpuid( r, int( 0x80000007 ) );
+            return ( r[3] >> 8 ) & 1;
+        )
+        $melse(
+            unsigned a, b, c, d;
+            if( __get_cpuid_max( 0x80000000, 0 ) < 0x80000007 ) return false;
+            __cpuid( 0x80000007, a, b, c, d );
+            return ( d >> 8 ) & 1;
+        )
+#else
+        return false;
+#endif
+    }
+
+    inline uint64_t read_tsc() {
+#if SOLE_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    inline uint64_t tsc_scale( uint64_t delta, uint64_t mult ) {
+        return ( delta >> 32 ) * mult + ( ( ( delta & 0xFFFFFFFF ) * mult ) >> 32 );
+    }
+
+    // Calibrates or resyncs. Whoever loses the race for the lock reads CLOCK_REALTIME.
+    inline uint64_t tsc_resync() {
+        tsc_clock &c = tsc_state();
+        uint32_t s = c.seq.load( std::memory_order_relaxed );
+        if( ( s & 1 ) || !c.seq.compare_exchange_strong( s, s + 1, std::memory_order_acquire ) )
+            return read_realtime();
+        std::atomic_thread_fence( std::memory_order_release );
+
+        // bracket the realtime read with tsc reads, keep the middle of the tightest of three
+        uint64_t tsc = 0, now = 0, width = ~0ULL;
+        for( int i = 0; i < 3; ++i ) {
+            uint64_t t0 = read_tsc(), r = read_realtime(), t1 = read_tsc();
+            if( t1 - t0 < width ) width = t1 - t0, tsc = t0 + width / 2, now = r;
+        }
+        uint64_t value = now;
+
+        // A preempted sample is off by its bracket width: samples must be tight against
+        // the baseline they measure (0.1%), else try again on a later call.
+        bool usable;
+        if( !s ) {
+            if( !c.first_tsc || width < c.first_width / 2 ) { // (re)start calibration from a tighter sample
+                c.first_tsc = tsc, c.first_ticks = now, c.first_width = width;
+                usable = false;
+            } else {
+                usable = now - c.first_ticks >= tsc_clock::calibrate_ticks && tsc > c.first_tsc
+                      && ( width + c.first_width ) * 1000 <= tsc - c.first_tsc;
+            }
+        } else {
+            usable = width * 1000 <= c.next.load( std::memory_order_relaxed ) - c.tsc0.load( std::memory_order_relaxed );
+        }
+        if( !usable ) {
+            c.seq.store( s, std::memory_order_release ); // nothing changed
+            return now;
+        }
+
+        double rate = double( now - c.first_ticks ) / double( tsc - c.first_tsc ); // ticks per cycle
+        double adjust = 0;
+        if( s ) {
+            uint64_t t = c.tsc0.load( std::memory_order_relaxed );
+            uint64_t extrapolated = c.base.load( std::memory_order_relaxed ) + tsc_scale( tsc - t, c.mult.load( std::memory_order_relaxed ) );
+            int64_t error = int64_t( now - extrapolated );
+            if( tsc >= t && ( error < 0 ? -error : error ) < int64_t( tsc_clock::step_ticks ) ) {
+                value = extrapolated;
+                double limit = 1e-6 * double( tsc_clock::max_ppm );
+                adjust = double( error ) / double( tsc_clock::resync_ticks );
+                adjust = std::max( -limit, std::min( limit, adjust ) );
+            }
+        }
+        c.tsc0.store( tsc, std::memory_order_relaxed );
+        c.base.store( value, std::memory_order_relaxed );
+        c.mult.store( uint64_t( rate * ( 1 + adjust ) * 4294967296.0 ), std::memory_order_relaxed );
+        c.next.store( tsc + uint64_t( double( tsc_clock::resync_ticks ) / rate ), std::memory_order_relaxed );
+        c.seq.store( s ? s + 2 : 2, std::memory_order_release );
+        return value;
+    }
+
+    inline uint64_t read_tsc_clock() {
+        tsc_clock &c = tsc_state();
+        uint32_t s = c.seq.load( std::memory_order_acquire );
+        uint64_t tsc = read_tsc();
+        if( s && !( s & 1 ) ) {
+            uint64_t tsc0 = c.tsc0.load( std::memory_order_relaxed ), base = c.base.load( std::memory_order_relaxed );
+            uint64_t mult = c.mult.load( std::memory_order_relaxed ), next = c.next.load( std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if( c.seq.load( std::memory_order_relaxed ) == s && tsc >= tsc0 && tsc < next )
+                return base + tsc_scale( tsc - tsc0, mult );
+        }
+        return tsc_resync();
+    }
+
+    inline clock_source usable_clock_source( clock_source src ) {
+        if( src == clock_coarse && !coarse_resolution() ) return clock_realtime;
+        if( src == clock_tsc && !has_invariant_tsc() ) return clock_realtime;
+        return src;
+    }
+
+    inline std::atomic<int> &clock_policy() {
+        static std::atomic<int> policy( usable_clock_source( SOLE_CLOCK_SOURCE ) );
+        return policy;
+    }
+
+    inline void set_clock_source( clock_source src ) {
+        clock_policy().store( usable_clock_source( src ), std::memory_order_relaxed );
+    }
+
+    inline clock_source get_clock_source() {
+        return clock_source( clock_policy().load( std::memory_order_relaxed ) );
+    }
+
+    // Reads selected clock in 100ns intervals since Unix epoch
+    inline uint64_t read_clock() {
+        switch( clock_policy().load( std::memory_order_relaxed ) ) {
+            case clock_coarse: return read_coarse();
+            case clock_tsc: return read_tsc_clock();
+            default: return read_realtime();
+        }
+    }
+
+    inline int64_t clock_drift() {
+        uint64_t source = read_clock();
+        return int64_t( source - read_realtime() );
+    }
+
+    struct clock_state {
+        std::atomic<uint64_t> last_uuid_time; // last tick handed out
+        std::atomic<uint64_t> regressions;
+        std::atomic<uint64_t> saturations;
+        std::atomic<uint32_t> clock_seq;      // 14-bit sequence | 0x80000000 when set
+    };
+
+    inline clock_state &clock_shared() {
+        static clock_state state; // zero-initialized
+        return state;
+    }
+
+    // Returns first of `count` consecutive, unused 100ns intervals. Lock-free: ticks
+    // are strictly increasing across all threads, a range costs one CAS.
+    inline uint64_t get_time_range( uint64_t offset, uint64_t count ) {
+        uint64_t uuid_time = read_clock();
+
+        // Regressions are detected per thread: successive readings of one thread are
+        // ordered, while readings from different threads may interleave arbitrarily.
+        static $thread uint64_t last_clock = 0;
+        clock_state &st = clock_shared();
+        if( uuid_time < last_clock ) {
+            SOLE_PROBE( clock_regression, last_clock - uuid_time );
+            st.regressions.fetch_add( 1, std::memory_order_relaxed );
+            uint32_t seq = st.clock_seq.load( std::memory_order_relaxed );
+            if( seq & 0x80000000 )
+                st.clock_seq.compare_exchange_strong( seq, ( ( seq + 1 ) & 0x3fff ) | 0x80000000, std::memory_order_relaxed );
+        }
+        last_clock = uuid_time;
 
         // If the clock looks like it went backwards, or is the same, increment it.
-        static uint64_t last_uuid_time = 0;
-        if( last_uuid_time >= uuid_time )
-            uuid_time = ++last_uuid_time;
-        else
-            last_uuid_time = uuid_time;
+        uint64_t last = st.last_uuid_time.load( std::memory_order_relaxed ), first;
+        unsigned spins = ~0u;
+        do {
+            ++spins;
+            first = last >= uuid_time ? last + 1 : uuid_time;
+        } while( !st.last_uuid_time.compare_exchange_weak( last, first + count - 1, std::memory_order_relaxed ) );
+        if( spins ) SOLE_EVENT( clock_spin, spins );
+
+        if( first != uuid_time ) {
+            SOLE_PROBE( clock_saturation, first - uuid_time );
+            st.saturations.fetch_add( 1, std::memory_order_relaxed );
+        }
 
-        uuid_time = uuid_time + offset;
+        return first + offset;
+    }
 
-        return uuid_time;
+    // Returns number of 100ns intervals
+    inline uint64_t get_time( uint64_t offset ) {
+        return get_time_range( offset, 1 );
     }
 
     // Looks for first MAC address of any network device, any size.
@@ -657,42 +1637,368 @@ namespace sole {
     // Looks for first MAC address of any network device, size truncated to 48bits.
     inline uint64_t get_any_mac48() {
         std::vector<unsigned char> node;
+        uint64_t t = 0;
+        SOLE_EVENT( node_lookup, 1 );
         if( get_any_mac(node) ) {
-            std::stringstream ss;
-            ss << std::hex << std::setfill('0');
             node.resize(6);
             for( unsigned i = 0; i < 6; ++i )
-                ss << std::setw(2) << int(node[i]);
-            uint64_t t;
-            if( ss >> t )
-                return t;
+                t = ( t << 8 ) | node[i];
         }
-        return 0;
+        else SOLE_EVENT( node_failure, 1 );
+        return t;
     }
 
     //////////////////////////////////////////////////////////////////////////////////////
-    // UUID implementations
+    // Node identity cache
+
+    // Lock-free cache for MAC and PID. Each slot holds the value plus flag bits, so a
+    // single atomic load is enough on the fast path. Concurrent first calls may resolve
+    // twice; the result is the same, so the race is harmless.
+    struct node_cache {
+        enum : uint64_t {
+            valid  = 1ULL << 63,
+            pinned = 1ULL << 62,
+            mask48 = 0xFFFFFFFFFFFFULL
+        };
 
-    inline uuid uuid4() {
-        static $thread std::random_device rd;
-        static $thread std::uniform_int_distribution<uint64_t> dist(0, (uint64_t)(~0));
+        std::atomic<uint64_t> mac;
+        std::atomic<uint64_t> pid;
+        std::atomic<uint64_t> expires;  // time_t when cached mac goes stale, 0 = never
+        std::atomic<unsigned> interval; // refresh interval in seconds, 0 = never
+    };
 
-        uuid my;
+    inline node_cache &node_state() {
+        static node_cache cache; // zero-initialized: nothing resolved yet
+        return cache;
+    }
 
-        my.ab = dist(rd);
-        my.cd = dist(rd);
+    // Called in the child after fork(): pid changed and node may have. The child shares
+    // the parent's timestamp history, so v1 needs a fresh clock sequence too.
+    inline void reset_caches_after_fork() {
+        clock_shared().clock_seq.store( 0, std::memory_order_relaxed );
+        node_cache &c = node_state();
+        c.pid.store( 0, std::memory_order_relaxed );
+        if( !( c.mac.load( std::memory_order_relaxed ) & node_cache::pinned ) )
+            c.mac.store( 0, std::memory_order_relaxed );
+    }
 
-        my.ab = (my.ab & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
-        my.cd = (my.cd & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+    inline uint64_t get_node() {
+        node_cache &c = node_state();
+        uint64_t v = c.mac.load( std::memory_order_acquire );
+        if( v & node_cache::valid ) {
+            if( ( v & node_cache::pinned ) || !c.interval.load( std::memory_order_relaxed ) )
+                return v & node_cache::mask48;
+            if( uint64_t( std::time(0) ) < c.expires.load( std::memory_order_relaxed ) )
+                return v & node_cache::mask48;
+        }
+
+        fork_generation(); // make sure the fork handler that invalidates us is installed
+        uint64_t mac = get_any_mac48() & node_cache::mask48;
+        if( unsigned secs = c.interval.load( std::memory_order_relaxed ) )
+            c.expires.store( uint64_t( std::time(0) ) + secs, std::memory_order_relaxed );
+        // don't clobber a node pinned by set_node() meanwhile
+        if( !c.mac.compare_exchange_strong( v, mac | node_cache::valid, std::memory_order_acq_rel ) )
+            return v & node_cache::mask48;
+        return mac;
+    }
+
+    inline uint64_t get_pid() {
+        node_cache &c = node_state();
+        uint64_t v = c.pid.load( std::memory_order_relaxed );
+        if( v & node_cache::valid ) return v & ~node_cache::valid;
+        fork_generation(); // make sure the fork handler that invalidates us is installed
+        uint64_t pid = uint64_t( $windows( _getpid() ) $welse( getpid() ) );
+        c.pid.store( pid | node_cache::valid, std::memory_order_relaxed );
+        return pid;
+    }
+
+    inline void set_node( uint64_t mac48 ) {
+        fork_generation();
+        node_state().mac.store( ( mac48 & node_cache::mask48 ) | node_cache::valid | node_cache::pinned, std::memory_order_release );
+    }
+
+    inline void reset_node() {
+        node_state().mac.store( 0, std::memory_order_release );
+    }
+
+    inline void set_node_refresh( unsigned seconds ) {
+        fork_generation();
+        node_cache &c = node_state();
+        c.expires.store( 0, std::memory_order_relaxed );
+        c.interval.store( seconds, std::memory_order_relaxed );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Random interfaces
+
+    // Reads 64 bits from the OS entropy source. Slow: used for seeding only, unless
+    // SOLE_USE_RANDOM_DEVICE is defined.
+    inline uint64_t os_random64() {
+        static $thread std::random_device rd;
+        static $thread std::uniform_int_distribution<uint64_t> dist(0, (uint64_t)(~0));
+        SOLE_EVENT( entropy_read, 1 );
+        return dist(rd);
+    }
+
+    // Per-thread ChaCha20 keystream generator, seeded once from the OS and reseeded after
+    // fork() or every few megabytes. Uses fast key erasure: the first 32 bytes of every
+    // refill become the next key, so a leaked state does not reveal previous outputs.
+    struct chacha20 {
+        enum { blocks = 4, words = 16 * blocks, reseed_refills = 1 << 14 };
+
+        uint32_t key[8];
+        uint32_t out[words];
+        uint64_t counter;
+        unsigned pos;
+        unsigned refills;
+        unsigned generation;
+        bool seeded;
+
+        static inline uint32_t rotl( uint32_t v, int c ) {
+            return ( v << c ) | ( v >> ( 32 - c ) );
+        }
+
+        void block( uint64_t ctr, uint32_t *dst ) const {
+            uint32_t x[16] = {
+                0x61707865, 0x3320646e, 0x79622d32, 0x6b206574,
+                key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+                uint32_t(ctr), uint32_t(ctr >> 32), 0, 0
+            };
+            uint32_t in[16];
+            std::memcpy( in, x, sizeof(x) );
+#           define SOLE_QR(a,b,c,d) \
+                x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 16); \
+                x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 12); \
+                x[a] += x[b]; x[d] = rotl(x[d] ^ x[a],  8); \
+                x[c] += x[d]; x[b] = rotl(x[b] ^ x[c],  7);
+            for( int i = 0; i < 10; ++i ) {
+                SOLE_QR(0, 4,  8, 12) SOLE_QR(1, 5,  9, 13) SOLE_QR(2, 6, 10, 14) SOLE_QR(3, 7, 11, 15)
+                SOLE_QR(0, 5, 10, 15) SOLE_QR(1, 6, 11, 12) SOLE_QR(2, 7,  8, 13) SOLE_QR(3, 4,  9, 14)
+            }
+#           undef SOLE_QR
+            for( int i = 0; i < 16; ++i ) dst[i] = x[i] + in[i];
+        }
+
+        void seed() {
+            for( int i = 0; i < 8; i += 2 ) {
+                uint64_t r = os_random64();
+                key[i+0] = uint32_t(r);
+                key[i+1] = uint32_t(r >> 32);
+            }
+            counter = 0;
+            refills = 0;
+            pos = words;
+            generation = fork_generation();
+            seeded = true;
+        }
+
+        void refill() {
+            SOLE_EVENT( rng_refill, 1 );
+            if( ++refills >= reseed_refills ) seed();
+            for( int i = 0; i < blocks; ++i ) block( counter++, &out[16 * i] );
+            std::memcpy( key, out, sizeof(key) );
+            pos = 8;
+        }
+
+        void bytes( void *dst, size_t len ) {
+            if( !seeded || generation != fork_counter().load( std::memory_order_relaxed ) ) seed();
+            unsigned char *p = (unsigned char *)dst;
+            while( len ) {
+                if( pos == words ) refill();
+                size_t avail = ( words - pos ) * 4, n = len < avail ? len : avail;
+                std::memcpy( p, &out[pos], n );
+                pos += unsigned( ( n + 3 ) / 4 );
+                p += n, len -= n;
+            }
+        }
+    };
+
+    // Fills buffer with cryptographically strong random bytes.
+    inline void random_bytes( void *dst, size_t len ) {
+        SOLE_EVENT( random_bytes, len );
+#ifdef SOLE_USE_RANDOM_DEVICE
+        unsigned char *p = (unsigned char *)dst;
+        while( len ) {
+            uint64_t r = os_random64();
+            size_t n = len < 8 ? len : 8;
+            std::memcpy( p, &r, n );
+            p += n, len -= n;
+        }
+#else
+        static $thread chacha20 engine; // zero-initialized, seeded on first use
+        engine.bytes( dst, len );
+#endif
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Clock sequence
+
+    inline uint16_t get_clock_seq() {
+        clock_state &st = clock_shared();
+        fork_generation(); // a forked child must not reuse this sequence: install the handler
+        uint32_t seq = st.clock_seq.load( std::memory_order_relaxed );
+        if( seq & 0x80000000 ) return uint16_t( seq & 0x3fff );
+
+        uint16_t r;
+        random_bytes( &r, sizeof(r) );
+        uint32_t fresh = ( r & 0x3fff ) | 0x80000000;
+        if( !st.clock_seq.compare_exchange_strong( seq, fresh, std::memory_order_relaxed ) )
+            fresh = seq; // someone else won the race
+        return uint16_t( fresh & 0x3fff );
+    }
+
+    inline void set_clock_seq( uint16_t seq ) {
+        fork_generation();
+        clock_shared().clock_seq.store( ( seq & 0x3fff ) | 0x80000000, std::memory_order_relaxed );
+    }
+
+    inline clock_counters get_clock_counters() {
+        clock_state &st = clock_shared();
+        clock_counters c;
+        c.regressions = st.regressions.load( std::memory_order_relaxed );
+        c.saturations = st.saturations.load( std::memory_order_relaxed );
+        return c;
+    }
+
+    inline stats_snapshot stats() {
+        uint64_t sum[ stat_count ] = {};
+        for( stat_block *b = stat_blocks().load( std::memory_order_acquire ); b; b = b->next )
+            for( int i = 0; i < stat_count; ++i ) sum[i] += b->count[i].load( std::memory_order_relaxed );
+
+        stats_snapshot s;
+        for( int v = 0; v < 8; ++v ) s.generated[v] = v == 2 ? 0 : sum[v];
+        clock_counters c = get_clock_counters();
+        s.clock_regressions = c.regressions;
+        s.clock_saturations = c.saturations;
+        s.clock_spins = sum[ stat_clock_spin ];
+        s.node_lookups = sum[ stat_node_lookup ];
+        s.node_failures = sum[ stat_node_failure ];
+        s.entropy_reads = sum[ stat_entropy_read ];
+        s.rng_refills = sum[ stat_rng_refill ];
+        s.random_bytes = sum[ stat_random_bytes ];
+        s.parse_failures = sum[ stat_parse_failure ];
+        return s;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // UUID implementations
+
+    inline uuid uuid4() {
+        SOLE_EVENT( uuid4, 1 );
+        uuid my;
+        random_bytes( &my, sizeof(my) );
+
+        my.ab = (my.ab & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
+        my.cd = (my.cd & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
 
         return my;
     }
 
-    inline uuid uuid1() {
-        // Number of 100-ns intervals since 00:00:00.00 15 October 1582; [ref] uuid.py
-        uint64_t ns100_intervals = get_time( 0x01b21dd213814000ULL );
-        uint16_t clock_seq = (uint16_t)( ns100_intervals & 0x3fff );  // 14-bits max
-        uint64_t mac = get_any_mac48();                               // 48-bits max
+    inline void uuid4_n( uuid *out, size_t n ) {
+        SOLE_EVENT( uuid4, n );
+        random_bytes( out, n * sizeof(uuid) );
+
+        // Stamp version and variant bits, same masks as uuid4()
+        size_t i = 0;
+#if SOLE_AVX2
+        const __m256i and4 = _mm256_set_epi64x( 0x3FFFFFFFFFFFFFFFLL, 0xFFFFFFFFFFFF0FFFLL, 0x3FFFFFFFFFFFFFFFLL, 0xFFFFFFFFFFFF0FFFLL );
+        const __m256i or4  = _mm256_set_epi64x( (long long)0x8000000000000000ULL, 0x4000, (long long)0x8000000000000000ULL, 0x4000 );
+        for( ; i + 2 <= n; i += 2 ) {
+            __m256i v = _mm256_loadu_si256( (const __m256i *)&out[i] );
+            _mm256_storeu_si256( (__m256i *)&out[i], _mm256_or_si256( _mm256_and_si256( v, and4 ), or4 ) );
+        }
+#elif SOLE_SSE2
+        const __m128i and4 = _mm_set_epi64x( 0x3FFFFFFFFFFFFFFFLL, 0xFFFFFFFFFFFF0FFFLL );
+        const __m128i or4  = _mm_set_epi64x( (long long)0x8000000000000000ULL, 0x4000 );
+        for( ; i < n; ++i ) {
+            __m128i v = _mm_loadu_si128( (const __m128i *)&out[i] );
+            _mm_storeu_si128( (__m128i *)&out[i], _mm_or_si128( _mm_and_si128( v, and4 ), or4 ) );
+        }
+#endif
+        for( ; i < n; ++i ) {
+            out[i].ab = (out[i].ab & 0xFFFFFFFFFFFF0FFFULL) | 0x0000000000004000ULL;
+            out[i].cd = (out[i].cd & 0x3FFFFFFFFFFFFFFFULL) | 0x8000000000000000ULL;
+        }
+    }
+
+    inline std::vector<uuid> uuid4_n( size_t n ) {
+        std::vector<uuid> v( n );
+        uuid4_n( v.data(), n );
+        return v;
+    }
+
+    // Per-thread state for v7: last millisecond used and a 42-bit counter spread over
+    // rand_a (12 bits) and the top of rand_b (30 bits), RFC 9562 section 6.2 method 1.
+    // The counter restarts at a random value with its top bit clear on every new
+    // millisecond; on overflow the timestamp is advanced instead, so ids issued by a
+    // thread are strictly increasing even if the clock stalls or goes backwards.
+    struct uuid7_state {
+        uint64_t ms;
+        uint64_t counter;
+
+        void next( uint64_t now_ms ) {
+            if( now_ms > ms ) {
+                ms = now_ms;
+                reseed();
+            }
+            else if( ++counter >> 42 ) {
+                ++ms;
+                reseed();
+            }
+        }
+
+        void reseed() {
+            random_bytes( &counter, sizeof(counter) );
+            counter &= 0x1FFFFFFFFFFULL; // 41 bits: leave room to count
+        }
+    };
+
+    inline uuid7_state &uuid7_thread_state() {
+        static $thread uuid7_state st; // zero-initialized
+        return st;
+    }
+
+    inline uuid make_uuid7( uint64_t ms, uint64_t counter, uint32_t rand32 ) {
+        uuid u;
+        u.ab = ( ms << 16 ) | 0x7000 | ( counter >> 30 );
+        u.cd = 0x8000000000000000ULL | ( ( counter & 0x3FFFFFFF ) << 32 ) | rand32;
+        return u;
+    }
+
+    inline uuid uuid7() {
+        SOLE_EVENT( uuid7, 1 );
+        uuid7_state &st = uuid7_thread_state();
+        st.next( read_clock() / 10000 );
+
+        uint32_t rand32;
+        random_bytes( &rand32, sizeof(rand32) );
+        return make_uuid7( st.ms, st.counter, rand32 );
+    }
+
+    inline void uuid7_n( uuid *out, size_t n ) {
+        SOLE_EVENT( uuid7, n );
+        uuid7_state &st = uuid7_thread_state();
+        uint64_t now_ms = read_clock() / 10000;
+
+        // Draw the 32 random tail bits a chunk of ids at a time
+        uint32_t tails[256];
+        for( size_t i = 0; i < n; ) {
+            size_t m = std::min( n - i, sizeof(tails) / sizeof(tails[0]) );
+            random_bytes( tails, m * sizeof(tails[0]) );
+            for( size_t j = 0; j < m; ++j, ++i ) {
+                st.next( now_ms );
+                out[i] = make_uuid7( st.ms, st.counter, tails[j] );
+            }
+        }
+    }
+
+    inline std::vector<uuid> uuid7_n( size_t n ) {
+        std::vector<uuid> v( n );
+        uuid7_n( v.data(), n );
+        return v;
+    }
+
+    inline uuid make_uuid1( uint64_t ns100_intervals, uint16_t clock_seq, uint64_t mac ) {
 
         uint32_t time_low = ns100_intervals & 0xffffffff;
         uint16_t time_mid = (ns100_intervals >> 32) & 0xffff;
@@ -725,12 +2031,91 @@ namespace sole {
         return u;
     }
 
-    inline uuid uuid0() {
-        // Number of 100-ns intervals since Unix epoch time
-        uint64_t ns100_intervals = get_time( 0 );
-        uint64_t pid = $windows( _getpid() ) $welse( getpid() );
+    // v1 fields for now, shared by v1 and v6
+    inline uuid next_uuid1() {
+        // Number of 100-ns intervals since 00:00:00.00 15 October 1582; [ref] uuid.py
+        uint64_t ns100_intervals = get_time( 0x01b21dd213814000ULL );
+        uint16_t clock_seq = get_clock_seq();                         // 14-bits max
+        uint64_t mac = get_node();                                    // 48-bits max
+        return make_uuid1( ns100_intervals, clock_seq, mac );
+    }
+
+    inline void next_uuid1_n( uuid *out, size_t n ) {
+        if( !n ) return;
+        uint64_t ns100_intervals = get_time_range( 0x01b21dd213814000ULL, n );
+        uint16_t clock_seq = get_clock_seq();
+        uint64_t mac = get_node();
+        for( size_t i = 0; i < n; ++i )
+            out[i] = make_uuid1( ns100_intervals + i, clock_seq, mac );
+    }
+
+    inline uuid uuid1() {
+        SOLE_EVENT( uuid1, 1 );
+        return next_uuid1();
+    }
+
+    inline void uuid1_n( uuid *out, size_t n ) {
+        SOLE_EVENT( uuid1, n );
+        next_uuid1_n( out, n );
+    }
+
+    inline std::vector<uuid> uuid1_n( size_t n ) {
+        std::vector<uuid> v( n );
+        uuid1_n( v.data(), n );
+        return v;
+    }
+
+    // v6 keeps v1's clock_seq/node half and stores the 60-bit timestamp most significant
+    // bits first: time_high(32) | time_mid(16) | version(4) | time_low(12).
+    inline uint64_t v1_ab_to_v6( uint64_t ab ) {
+        uint64_t ts = ( ( ab & 0x0FFF ) << 48 ) | ( ( ( ab >> 16 ) & 0xFFFF ) << 32 ) | ( ab >> 32 );
+        return ( ( ts >> 12 ) << 16 ) | 0x6000 | ( ts & 0x0FFF );
+    }
+
+    inline uint64_t v6_ab_to_v1( uint64_t ab ) {
+        uint64_t ts = ( ( ab >> 16 ) << 12 ) | ( ab & 0x0FFF );
+        return ( ( ts & 0xFFFFFFFF ) << 32 ) | ( ( ( ts >> 32 ) & 0xFFFF ) << 16 ) | 0x1000 | ( ts >> 48 );
+    }
+
+    inline uuid uuid6() {
+        SOLE_EVENT( uuid6, 1 );
+        uuid u = next_uuid1();
+        u.ab = v1_ab_to_v6( u.ab );
+        return u;
+    }
+
+    inline void uuid6_n( uuid *out, size_t n ) {
+        SOLE_EVENT( uuid6, n );
+        next_uuid1_n( out, n );
+        for( size_t i = 0; i < n; ++i )
+            out[i].ab = v1_ab_to_v6( out[i].ab );
+    }
+
+    inline std::vector<uuid> uuid6_n( size_t n ) {
+        std::vector<uuid> v( n );
+        uuid6_n( v.data(), n );
+        return v;
+    }
+
+    // Branch-free: the converted half is selected with a mask, so loops vectorize.
+    inline void v1_to_v6( uuid *ids, size_t n ) {
+        for( size_t i = 0; i < n; ++i ) {
+            uint64_t ab = ids[i].ab;
+            uint64_t keep = uint64_t( ( ( ab >> 12 ) & 0xF ) == 1 ) - 1; // all ones unless v1
+            ids[i].ab = ( ab & keep ) | ( v1_ab_to_v6( ab ) & ~keep );
+        }
+    }
+
+    inline void v6_to_v1( uuid *ids, size_t n ) {
+        for( size_t i = 0; i < n; ++i ) {
+            uint64_t ab = ids[i].ab;
+            uint64_t keep = uint64_t( ( ( ab >> 12 ) & 0xF ) == 6 ) - 1; // all ones unless v6
+            ids[i].ab = ( ab & keep ) | ( v6_ab_to_v1( ab ) & ~keep );
+        }
+    }
+
+    inline uuid make_uuid0( uint64_t ns100_intervals, uint64_t pid, uint64_t mac ) {
         uint16_t pid16 = (uint16_t)( pid & 0xffff ); // 16-bits max
-        uint64_t mac = get_any_mac48();              // 48-bits max
 
         uint32_t time_low = ns100_intervals & 0xffffffff;
         uint16_t time_mid = (ns100_intervals >> 32) & 0xffff;
@@ -759,196 +2144,3058 @@ namespace sole {
         return u;
     }
 
+    inline uuid uuid0() {
+        SOLE_EVENT( uuid0, 1 );
+        // Number of 100-ns intervals since Unix epoch time
+        uint64_t ns100_intervals = get_time( 0 );
+        uint64_t pid = get_pid();
+        uint64_t mac = get_node();                   // 48-bits max
+        return make_uuid0( ns100_intervals, pid, mac );
+    }
+
+    inline void uuid0_n( uuid *out, size_t n ) {
+        SOLE_EVENT( uuid0, n );
+        if( !n ) return;
+        uint64_t ns100_intervals = get_time_range( 0, n );
+        uint64_t pid = get_pid();
+        uint64_t mac = get_node();
+        for( size_t i = 0; i < n; ++i )
+            out[i] = make_uuid0( ns100_intervals + i, pid, mac );
+    }
+
+    inline std::vector<uuid> uuid0_n( size_t n ) {
+        std::vector<uuid> v( n );
+        uuid0_n( v.data(), n );
+        return v;
+    }
+
     inline uuid rebuild( uint64_t ab, uint64_t cd ) {
         uuid u;
         u.ab = ab; u.cd = cd;
         return u;
     }
 
-    inline uuid rebuild( const std::string &uustr ) {
-        uuid u = { 0, 0 };
-        auto idx = uustr.find_first_of("-");
-        if( idx != std::string::npos ) {
-            // single separator, base62 notation
-            if( uustr.find_first_of("-",idx+1) == std::string::npos ) {
-                auto rebase62 = [&]( const char *input, size_t limit ) -> uint64_t {
-                    int base62len = 10 + 26 + 26;
-                    auto strpos = []( char ch ) -> size_t {
-                        if( ch >= 'a' ) return ch - 'a' + 10 + 26;
-                        if( ch >= 'A' ) return ch - 'A' + 10;
-                        return ch - '0';
-                    };
-                    uint64_t res = strpos( input[0] );
-                    for( size_t i = 1; i < limit; ++i )
-                        res = base62len * res + strpos( input[i] );
-                    return res;
-                };
-                u.ab = rebase62( &uustr[0], idx );
-                u.cd = rebase62( &uustr[idx+1], uustr.size() - (idx+1) );
-            }
-            // else classic hex notation
-            else {
-                if (uustr[8] == '-' || uustr[13] == '-' || uustr[18] == '-' || uustr[23] == '-') {
-                    auto decode = []( char ch ) -> size_t {
-                        if( 'f' >= ch && ch >= 'a' ) return ch - 'a' + 10;
-                        if( 'F' >= ch && ch >= 'A' ) return ch - 'A' + 10;
-                        if( '9' >= ch && ch >= '0' ) return ch - '0';
-                        return 0;
-                    };
-                    for( size_t i = 0; i < 18; i++ ) {
-                        if( i == 8 || i == 13 ) {
-                            continue;
-                        }
-                        u.ab = u.ab<<4 | decode(uustr[i]);
-                    }
-                    for( size_t i = 19; i < 36; i++ ) {
-                        if( i == 23 ) {
-                            continue;
-                        }
-                        u.cd = u.cd<<4 | decode(uustr[i]);
-                    }
-                }
-            }
-        }
-        return u;
+    // Scalar hex decoding. constexpr, so literals and the runtime fallback share the code.
+    constexpr int hex_value( char ch ) {
+        return '0' <= ch && ch <= '9' ? ch - '0'
+             : 'a' <= ch && ch <= 'f' ? ch - 'a' + 10
+             : 'A' <= ch && ch <= 'F' ? ch - 'A' + 10 : -1;
     }
 
-} // ::sole
+    // Text position of k-th hex digit, in plain (32 chars) or dashed (36 chars) form.
+    constexpr size_t hex_pos( size_t k, bool dashed ) {
+        return dashed ? k + ( k >= 8 ) + ( k >= 12 ) + ( k >= 16 ) + ( k >= 20 ) : k;
+    }
 
-#undef $bsd
-#undef $belse
-#undef $linux
-#undef $lelse
-#undef $osx
-#undef $oelse
-#undef $unix
-#undef $uelse
-#undef $windows
-#undef $welse
-#undef $yes
-#undef $no
+    constexpr bool hex_valid( const char *text, size_t k, size_t end, bool dashed ) {
+        return k == end || ( hex_value( text[ hex_pos( k, dashed ) ] ) >= 0 && hex_valid( text, k + 1, end, dashed ) );
+    }
 
-// Pop disabled warnings
-#if (defined(__APPLE__) && defined(__MACH__))
-#pragma clang diagnostic pop
-#endif
+    constexpr uint64_t hex_fold( const char *text, size_t k, size_t end, bool dashed, uint64_t acc = 0 ) {
+        return k == end ? acc : hex_fold( text, k + 1, end, dashed, acc << 4 | uint64_t( hex_value( text[ hex_pos( k, dashed ) ] ) & 15 ) );
+    }
 
-#ifdef SOLE_BUILD_DEMO
-// g++ users: `g++ demo.cc -std=c++11 -lrt -o sample`
-// visual studio: `cl.exe demo.cc sole.cpp`
+    constexpr bool hex_dashes( const char *text ) {
+        return text[8] == '-' && text[13] == '-' && text[18] == '-' && text[23] == '-';
+    }
 
-#include <iostream>
+    // Not constexpr on purpose: reaching it while evaluating a literal is a compile error.
+    inline uuid invalid_uuid_literal() {
+        return uuid{ 0, 0 };
+    }
 
-int main() {
-    sole::uuid u0 = sole::uuid0(), u1 = sole::uuid1(), u4 = sole::uuid4();
+    constexpr uuid parse_literal( const char *text, size_t len ) {
+        return len == 38 && text[0] == '{' && text[37] == '}' ? parse_literal( text + 1, 36 )
+             : len == 36 && hex_dashes( text ) && hex_valid( text, 0, 32, true ) ? uuid{ hex_fold( text, 0, 16, true ), hex_fold( text, 16, 32, true ) }
+             : len == 32 && hex_valid( text, 0, 32, false ) ? uuid{ hex_fold( text, 0, 16, false ), hex_fold( text, 16, 32, false ) }
+             : invalid_uuid_literal();
+    }
 
-    std::cout << "uuid v0 string : " << u0 << std::endl;
-    std::cout << "uuid v0 base62 : " << u0.base62() << std::endl;
-    std::cout << "uuid v0 pretty : " << u0.pretty() << std::endl << std::endl;
+    inline namespace literals {
+        constexpr uuid operator"" _uuid( const char *text, size_t len ) {
+            return parse_literal( text, len );
+        }
+    }
 
-    std::cout << "uuid v1 string : " << u1 << std::endl;
-    std::cout << "uuid v1 base62 : " << u1.base62() << std::endl;
-    std::cout << "uuid v1 pretty : " << u1.pretty() << std::endl << std::endl;
+    // Base62 digit values, 255 for invalid characters.
+    inline const unsigned char *base62_table() {
+        static const unsigned char table[256] = {
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+              0,   1,   2,   3,   4,   5,   6,   7,   8,   9, 255, 255, 255, 255, 255, 255,
+            255,  10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,
+             25,  26,  27,  28,  29,  30,  31,  32,  33,  34,  35, 255, 255, 255, 255, 255,
+            255,  36,  37,  38,  39,  40,  41,  42,  43,  44,  45,  46,  47,  48,  49,  50,
+             51,  52,  53,  54,  55,  56,  57,  58,  59,  60,  61, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+            255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+        };
+        return table;
+    }
 
-    std::cout << "uuid v4 string : " << u4 << std::endl;
-    std::cout << "uuid v4 base62 : " << u4.base62() << std::endl;
-    std::cout << "uuid v4 pretty : " << u4.pretty() << std::endl << std::endl;
+    // Decodes 32 hex digits into ab, cd. Returns false on any invalid digit.
+    inline bool decode_hex32( const char *hex, uint64_t &ab, uint64_t &cd ) {
+#if SOLE_SSE2
+        // unsigned range checks via signed compares on values biased by 0x80
+        const __m128i bias = _mm_set1_epi8( char(0x80) );
+        __m128i half[2];
+        unsigned valid = 0;
+        for( int i = 0; i < 2; ++i ) {
+            __m128i v = _mm_loadu_si128( (const __m128i *)( hex + 16 * i ) );
+            __m128i d = _mm_sub_epi8( v, _mm_set1_epi8( '0' ) );
+            __m128i l = _mm_sub_epi8( _mm_or_si128( v, _mm_set1_epi8( 0x20 ) ), _mm_set1_epi8( 'a' ) );
+            __m128i is_digit = _mm_cmplt_epi8( _mm_xor_si128( d, bias ), _mm_set1_epi8( char(0x80 + 10) ) );
+            __m128i is_alpha = _mm_cmplt_epi8( _mm_xor_si128( l, bias ), _mm_set1_epi8( char(0x80 + 6) ) );
+            valid |= unsigned( _mm_movemask_epi8( _mm_or_si128( is_digit, is_alpha ) ) ) << ( 16 * i );
+            __m128i nib = _mm_or_si128( _mm_and_si128( is_digit, d ),
+                                        _mm_and_si128( is_alpha, _mm_add_epi8( l, _mm_set1_epi8( 10 ) ) ) );
+            // each 16-bit lane holds (high nibble, low nibble) in memory order
+            half[i] = _mm_or_si128( _mm_and_si128( _mm_slli_epi16( nib, 4 ), _mm_set1_epi16( 0xF0 ) ),
+                                    _mm_srli_epi16( nib, 8 ) );
+        }
+        if( valid != 0xFFFFFFFFu ) return false;
+        uint64_t be[2];
+        _mm_storeu_si128( (__m128i *)be, _mm_packus_epi16( half[0], half[1] ) );
+        ab = bswap64( be[0] );
+        cd = bswap64( be[1] );
+        return true;
+#else
+        if( !hex_valid( hex, 0, 32, false ) ) return false;
+        ab = hex_fold( hex, 0, 16, false );
+        cd = hex_fold( hex, 16, 32, false );
+        return true;
+#endif
+    }
 
-    u1 = sole::rebuild("F81D4FAE-7DEC-11D0-A765-00A0C91E6BF6");
-    u4 = sole::rebuild("GITheR4tLlg-BagIW20DGja");
+    // Decodes 1 to 11 base62 digits (zero-padded or not), checking 64-bit overflow. Digits
+    // are accumulated in 32-bit chunks of up to 5, then merged with one 64-bit multiply.
+    inline parse_error decode_base62( const char *text, size_t len, uint64_t &out ) {
+        if( len < 1 || len > 11 ) return parse_bad_format;
+        const unsigned char *table = base62_table();
+        const unsigned char *in = (const unsigned char *)text;
+        const uint64_t p5 = 916132832ULL; // 62^5
+
+        unsigned bad = 0;
+        size_t head = len % 5, i = 0;
+        uint32_t lead = 0;
+        for( ; i < head; ++i ) bad |= table[in[i]], lead = lead * 62 + table[in[i]];
+        uint64_t res = lead;
+        for( ; i < len; i += 5 ) {
+            uint32_t chunk = 0;
+            for( size_t j = i; j < i + 5; ++j ) bad |= table[in[j]], chunk = chunk * 62 + table[in[j]];
+            res = res * p5 + chunk;
+        }
+        if( bad & 0x80 ) return parse_bad_char;
 
-    std::cout << "uuid v1 rebuilt : " << u1 << " -> " << u1.pretty() << std::endl;
-    std::cout << "uuid v4 rebuilt : " << u4 << " -> " << u4.pretty() << std::endl;
-}
+        // only 11 digits can overflow: 2^64-1 = 21 * 62^10 + 821457390474406911
+        if( len == 11 && ( lead > 21 || ( lead == 21 && res - 21 * p5 * p5 > 821457390474406911ULL ) ) )
+            return parse_overflow;
 
-#endif
+        out = res;
+        return parse_ok;
+    }
 
-#ifdef SOLE_BUILD_TESTS
-// g++ users: `g++ sole.cxx -std=c++11 -lrt -o tests`
-// visual studio: `cl.exe sole.cxx`
+    inline parse_error parse_text( const char *text, size_t len, uuid &out ) {
+        // strip decorations, then dispatch on remaining length
+        if( len == 38 ) {
+            if( text[0] != '{' || text[37] != '}' ) return parse_bad_format;
+            ++text, len -= 2;
+        }
+        else if( len == 45 ) {
+            const char urn[] = "urn:uuid:";
+            for( int i = 0; i < 9; ++i )
+                if( ( text[i] | ( text[i] >= 'A' && text[i] <= 'Z' ? 0x20 : 0 ) ) != urn[i] ) return parse_bad_format;
+            text += 9, len -= 9;
+        }
 
-#include <cassert>
-#include <set>
-#include <ratio>
-#include <chrono>
-#include <iostream>
+        uuid u;
+        if( len == 36 ) {
+            if( !hex_dashes( text ) )
+                return parse_bad_format;
+            char hex[32];
+            std::memcpy( hex +  0, text +  0, 8 );
+            std::memcpy( hex +  8, text +  9, 4 );
+            std::memcpy( hex + 12, text + 14, 4 );
+            std::memcpy( hex + 16, text + 19, 4 );
+            std::memcpy( hex + 20, text + 24, 12 );
+            if( !decode_hex32( hex, u.ab, u.cd ) ) return parse_bad_char;
+        }
+        else if( len == 32 ) {
+            if( !decode_hex32( text, u.ab, u.cd ) ) return parse_bad_char;
+        }
+        else if( len >= 3 && len <= uuid::base62_max_size ) {
+            // single separator, base62 notation
+            const char *sep = (const char *)std::memchr( text, '-', len );
+            if( !sep ) return parse_bad_format;
+            size_t idx = size_t( sep - text );
+            parse_error err = decode_base62( text, idx, u.ab );
+            if( err == parse_ok ) err = decode_base62( sep + 1, len - idx - 1, u.cd );
+            if( err != parse_ok ) return err;
+        }
+        else {
+            return parse_bad_length;
+        }
 
-using namespace sole;
+        out = u;
+        return parse_ok;
+    }
 
-namespace run
-{
-    auto epoch = [](){
-        return std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
-    };
+    inline parse_error parse( const char *text, size_t len, uuid &out ) {
+        parse_error err = parse_text( text, len, out );
+        if( err != parse_ok ) SOLE_EVENT( parse_failure, 1 );
+        return err;
+    }
 
-    template<typename FN>
-    void benchmark( const FN &fn, const std::string &name ) {
-        std::cout << "Benchmarking " << name << "... " << std::flush;
+    inline uuid rebuild( const std::string &uustr ) {
+        uuid u = { 0, 0 };
+        parse( uustr.data(), uustr.size(), u );
+        return u;
+    }
 
-        auto then = epoch();
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Flat hash table
+
+    template<typename V, typename HASH>
+    inline uuid_table<V, HASH>::uuid_table( size_t reserve_for ) {
+        reserve( reserve_for );
+    }
 
-        while( epoch() == then );
-        then = epoch();
+    template<typename V, typename HASH>
+    inline size_t uuid_table<V, HASH>::memory_usage() const {
+        return sizeof(*this) + ctrl.capacity() + slots.capacity() * sizeof( uuid_slot<V> );
+    }
 
-        unsigned c = 0;
-        while( epoch() == then ) c = ( fn(), ++c );
+    template<typename V, typename HASH>
+    inline void uuid_table<V, HASH>::reserve( size_t n ) {
+        // max load factor 7/8
+        if( n > count + growth_left ) rehash( n + n / 7 + 1 );
+    }
 
-        std::cout << (c) << " uuids/sec" << std::endl;
+    template<typename V, typename HASH>
+    inline void uuid_table<V, HASH>::clear() {
+        std::fill( ctrl.begin(), ctrl.end(), (signed char)ctrl_empty );
+        std::fill( slots.begin(), slots.end(), uuid_slot<V>() );
+        count = 0;
+        growth_left = slots.size() - slots.size() / 8;
     }
 
-    template<typename FN>
-    void tests( const FN &fn ) {
-        unsigned numtests = ~0;
-        std::cout << "Testing for " << numtests << " collisions... " << std::endl;
+    template<typename V, typename HASH>
+    inline unsigned uuid_table<V, HASH>::match( size_t at, signed char tag ) const {
+#if SOLE_SSE2
+        __m128i g = _mm_loadu_si128( (const __m128i *)&ctrl[at] );
+        return unsigned( _mm_movemask_epi8( _mm_cmpeq_epi8( g, _mm_set1_epi8( tag ) ) ) );
+#else
+        unsigned bits = 0;
+        for( unsigned i = 0; i < group; ++i ) bits |= unsigned( ctrl[at + i] == tag ) << i;
+        return bits;
+#endif
+    }
 
-        auto then = epoch();
+    template<typename V, typename HASH>
+    inline unsigned uuid_table<V, HASH>::match_free( size_t at ) const {
+#if SOLE_SSE2
+        // empty and deleted are the only control bytes with top bit set
+        return unsigned( _mm_movemask_epi8( _mm_loadu_si128( (const __m128i *)&ctrl[at] ) ) );
+#else
+        unsigned bits = 0;
+        for( unsigned i = 0; i < group; ++i ) bits |= unsigned( ctrl[at + i] < 0 ) << i;
+        return bits;
+#endif
+    }
 
-        std::set<uuid> all;
-        for( unsigned i = 0; i < numtests; ++i ) {
-            auto now = epoch();
-            if( now != then ) {
-                then = now;
-                double pct6digs = ( int( ( double(i) / (unsigned)(~0) ) * 1e4 ) / double(1e4) );
-                std::cout << '\r' << i << " uuids generated, no collision (" << pct6digs << "%)" << std::flush;
+    template<typename V, typename HASH>
+    inline size_t uuid_table<V, HASH>::find_index( const uuid &key ) const {
+        if( !count ) return npos;
+        size_t h = hash( key ), groups = slots.size() / group;
+        signed char tag = (signed char)( h & 0x7F );
+        // triangular probing over groups visits every group once for power-of-two sizes
+        for( size_t g = ( h >> 7 ) & ( groups - 1 ), step = 1; ; g = ( g + step++ ) & ( groups - 1 ) ) {
+            size_t at = g * group;
+            for( unsigned bits = match( at, tag ); bits; bits &= bits - 1 ) {
+                size_t i = at + size_t( ctz32( bits ) );
+                if( same_uuid( slots[i].key, key ) ) return i;
             }
-            sole::uuid my_uuid = fn();
-            assert( all.find(my_uuid) == all.end() && "error: UUIDs just collided! is std::random_device a real random generator?" );
-            all.insert( my_uuid );
+            if( match( at, ctrl_empty ) ) return npos;
+            if( step > groups ) return npos;
         }
     }
 
-    template<typename FN>
-    void verify( const FN &fn ) {
-        std::cout << "Verifying serialization of 1 million UUIDs... " << std::flush;
+    template<typename V, typename HASH>
+    inline size_t uuid_table<V, HASH>::free_index( size_t h ) const {
+        size_t groups = slots.size() / group;
+        for( size_t g = ( h >> 7 ) & ( groups - 1 ), step = 1; ; g = ( g + step++ ) & ( groups - 1 ) ) {
+            if( unsigned bits = match_free( g * group ) )
+                return g * group + size_t( ctz32( bits ) );
+        }
+    }
 
-        for( unsigned i = 0; i < 1000000; ++i ) {
-            sole::uuid uuid = fn();
-            sole::uuid rebuilt1 = sole::rebuild( uuid.str() );
-            sole::uuid rebuilt2 = sole::rebuild( uuid.base62() );
+    template<typename V, typename HASH>
+    inline std::pair<size_t, bool> uuid_table<V, HASH>::insert_key( const uuid &key ) {
+        size_t found = find_index( key );
+        if( found != npos ) return std::make_pair( found, false );
+
+        // out of room: grow if mostly live keys, else purge tombstones at same size
+        if( !growth_left ) rehash( count >= slots.size() * 25 / 32 ? slots.size() * 2 : slots.size() );
+
+        size_t h = hash( key ), i = free_index( h );
+        if( ctrl[i] == ctrl_empty ) --growth_left; // reusing a tombstone costs no growth
+        ctrl[i] = (signed char)( h & 0x7F );
+        slots[i].key = key;
+        ++count;
+        return std::make_pair( i, true );
+    }
+
+    template<typename V, typename HASH>
+    inline bool uuid_table<V, HASH>::erase( const uuid &key ) {
+        size_t i = find_index( key );
+        if( i == npos ) return false;
+        // A group holding an empty slot never stopped a probe sequence, so no key was
+        // pushed past it: the slot can go back to empty instead of becoming a tombstone.
+        bool was_never_full = match( i - i % group, ctrl_empty ) != 0;
+        ctrl[i] = was_never_full ? (signed char)ctrl_empty : (signed char)ctrl_deleted;
+        growth_left += was_never_full;
+        slots[i] = uuid_slot<V>();
+        --count;
+        return true;
+    }
+
+    template<typename V, typename HASH>
+    inline void uuid_table<V, HASH>::rehash( size_t slots_wanted ) {
+        size_t cap = 2 * group;
+        while( cap < slots_wanted ) cap *= 2;
+
+        std::vector<signed char> old_ctrl( cap, (signed char)ctrl_empty );
+        std::vector< uuid_slot<V> > old_slots( cap );
+        old_ctrl.swap( ctrl );
+        old_slots.swap( slots );
+        growth_left = cap - cap / 8 - count;
+
+        for( size_t j = 0; j < old_slots.size(); ++j ) {
+            if( old_ctrl[j] < 0 ) continue;
+            size_t h = hash( old_slots[j].key ), i = free_index( h );
+            ctrl[i] = (signed char)( h & 0x7F );
+            slots[i] = std::move( old_slots[j] );
+        }
+    }
+
+    template<typename V>
+    inline V *uuid_map<V>::find( const uuid &key ) {
+        size_t i = this->find_index( key );
+        return i == this->npos ? 0 : &this->slots[i].value;
+    }
+
+    template<typename V>
+    inline const V *uuid_map<V>::find( const uuid &key ) const {
+        size_t i = this->find_index( key );
+        return i == this->npos ? 0 : &this->slots[i].value;
+    }
+
+    template<typename V>
+    inline bool uuid_map<V>::insert( const uuid &key, const V &value ) {
+        std::pair<size_t, bool> at = this->insert_key( key );
+        if( at.second ) this->slots[at.first].value = value;
+        return at.second;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Keyed hash
+
+    // Expands a seed into a stream of well-mixed, independent-looking words.
+    inline uint64_t splitmix64( uint64_t &state ) {
+        uint64_t z = ( state += 0x9e3779b97f4a7c15ULL );
+        z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+        return z ^ ( z >> 31 );
+    }
+
+    inline keyed_hash::keyed_hash( uint64_t seed ) {
+        k0 = splitmix64( seed );
+        k1 = splitmix64( seed );
+    }
+
+    inline keyed_hash::keyed_hash() {
+        static const uint64_t process_seed = []() {
+            uint64_t seed;
+            random_bytes( &seed, sizeof(seed) );
+            return seed;
+        }();
+        *this = keyed_hash( process_seed );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Bulk text codec
+
+    // Runs fn(i) for i in [0, tasks) on up to `threads` threads; the caller thread takes part.
+    template<typename FN>
+    inline void parallel_for( unsigned tasks, unsigned threads, const FN &fn ) {
+        if( threads > tasks ) threads = tasks;
+        if( threads <= 1 ) {
+            for( unsigned i = 0; i < tasks; ++i ) fn( i );
+            return;
+        }
+        std::vector<std::thread> pool;
+        for( unsigned t = 1; t < threads; ++t )
+            pool.emplace_back( [&, t]() { for( unsigned i = t; i < tasks; i += threads ) fn( i ); } );
+        for( unsigned i = 0; i < tasks; i += threads ) fn( i );
+        for( auto &th : pool ) th.join();
+    }
+
+    inline size_t encode_lines( const uuid *ids, size_t n, char *out, unsigned threads ) {
+        enum { line = uuid::str_size + 1 };
+        unsigned chunks = threads > 1 ? threads : 1;
+        parallel_for( chunks, threads, [&]( unsigned c ) {
+            size_t begin = n * c / chunks, end = n * ( c + 1 ) / chunks;
+            char *p = out + begin * line;
+            for( size_t i = begin; i < end; ++i ) {
+                p = ids[i].write_str( p );
+                *p++ = '\n';
+            }
+        } );
+        return n * line;
+    }
+
+    // Decodes whole lines in [buf, buf+len). Stops at first malformed line: chunks after
+    // a failing one are discarded, so line counts stay exact without counting past it.
+    struct lines_chunk {
+        std::vector<uuid> ids;
+        lines_result result;
+
+        void decode( const char *buf, size_t len ) {
+            result.count = result.lines = 0;
+            result.bad_line = size_t(-1);
+            result.error = parse_ok;
+            const char *end = buf + len;
+            while( buf < end ) {
+                const char *nl = (const char *)std::memchr( buf, '\n', size_t( end - buf ) );
+                const char *eol = nl ? nl : end;
+                size_t n = size_t( eol - buf );
+                if( n && buf[n - 1] == '\r' ) --n;
+                if( n ) {
+                    uuid u;
+                    parse_error err = parse( buf, n, u );
+                    if( err != parse_ok ) {
+                        result.bad_line = result.lines;
+                        result.error = err;
+                        break;
+                    }
+                    ids.push_back( u );
+                }
+                ++result.lines;
+                buf = nl ? nl + 1 : end;
+            }
+            result.count = ids.size();
+        }
+    };
+
+    inline lines_result decode_lines( const char *buf, size_t len, std::vector<uuid> &out, unsigned threads ) {
+        // split at newlines close to equal byte offsets
+        unsigned chunks = threads > 1 ? threads : 1;
+        std::vector<size_t> cuts( 1, 0 );
+        for( unsigned c = 1; c < chunks; ++c ) {
+            size_t at = len * c / chunks;
+            if( at < cuts.back() ) at = cuts.back();
+            const char *nl = (const char *)std::memchr( buf + at, '\n', len - at );
+            cuts.push_back( nl ? size_t( nl - buf ) + 1 : len );
+        }
+        cuts.push_back( len );
+
+        std::vector<lines_chunk> parts( chunks );
+        parallel_for( chunks, threads, [&]( unsigned c ) {
+            parts[c].ids.reserve( ( cuts[c + 1] - cuts[c] ) / ( uuid::str_size + 1 ) + 1 );
+            parts[c].decode( buf + cuts[c], cuts[c + 1] - cuts[c] );
+        } );
+
+        lines_result r = { 0, 0, size_t(-1), parse_ok };
+        out.reserve( out.size() + ( len / ( uuid::str_size + 1 ) ) );
+        for( auto &part : parts ) {
+            out.insert( out.end(), part.ids.begin(), part.ids.end() );
+            r.count += part.result.count;
+            if( part.result.error != parse_ok ) {
+                r.bad_line = r.lines + part.result.bad_line;
+                r.error = part.result.error;
+                r.lines += part.result.bad_line;
+                break;
+            }
+            r.lines += part.result.lines;
+        }
+        return r;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Radix sort
+
+    // k-th byte of the 128-bit key, k = 0 least significant (low byte of cd).
+    inline unsigned radix_digit( const uuid &u, int k ) {
+        return unsigned( ( k < 8 ? u.cd >> ( 8 * k ) : u.ab >> ( 8 * ( k - 8 ) ) ) & 0xFF );
+    }
+
+    // American flag sort on byte k, then recurse into buckets on byte k-1.
+    inline void msd_sort( uuid *first, uuid *last, int k ) {
+        for( ;; ) {
+            size_t n = size_t( last - first );
+            if( n < 64 || k < 0 ) {
+                std::sort( first, last );
+                return;
+            }
+
+            size_t count[256] = {};
+            for( uuid *p = first; p < last; ++p ) ++count[ radix_digit( *p, k ) ];
+            if( count[ radix_digit( *first, k ) ] == n ) { --k; continue; } // constant byte
+
+            size_t head[256], tail[256], sum = 0;
+            for( int d = 0; d < 256; ++d ) head[d] = sum, sum += count[d], tail[d] = sum;
+            for( int b = 0; b < 256; ++b ) {
+                while( head[b] < tail[b] ) {
+                    uuid v = first[ head[b] ];
+                    unsigned d = radix_digit( v, k );
+                    while( d != unsigned(b) ) {
+                        std::swap( v, first[ head[d]++ ] );
+                        d = radix_digit( v, k );
+                    }
+                    first[ head[b]++ ] = v;
+                }
+            }
+            size_t begin = 0;
+            for( int d = 0; d < 256; ++d ) {
+                if( count[d] > 1 ) msd_sort( first + begin, first + begin + count[d], k - 1 );
+                begin += count[d];
+            }
+            return;
+        }
+    }
+
+    inline void sort_inplace( uuid *first, uuid *last ) {
+        msd_sort( first, last, 15 );
+    }
+
+    // Scatters on the most significant byte that varies (v6/v7 share their top bytes),
+    // through a buffer so the first and largest pass streams memory, then sorts buckets.
+    inline void sort_parallel( uuid *first, uuid *last, unsigned threads ) {
+        size_t n = size_t( last - first );
+        if( n < 256 ) return std::sort( first, last );
+
+        uint64_t diff_ab = 0, diff_cd = 0;
+        for( uuid *p = first; p < last; ++p ) diff_ab |= p->ab ^ first->ab, diff_cd |= p->cd ^ first->cd;
+        if( !( diff_ab | diff_cd ) ) return;
+        int k = 15;
+        while( !( ( k < 8 ? diff_cd >> ( 8 * k ) : diff_ab >> ( 8 * ( k - 8 ) ) ) & 0xFF ) ) --k;
+
+        size_t offset[257] = {};
+        for( uuid *p = first; p < last; ++p ) ++offset[ radix_digit( *p, k ) + 1 ];
+        for( int d = 0; d < 256; ++d ) offset[d + 1] += offset[d];
+
+        std::unique_ptr<uuid[]> buf( new uuid[n] );
+        size_t fill[256];
+        std::memcpy( fill, offset, sizeof(fill) );
+        for( uuid *p = first; p < last; ++p ) buf[ fill[ radix_digit( *p, k ) ]++ ] = *p;
+
+        if( !threads ) threads = std::thread::hardware_concurrency();
+        if( n < 65536 ) threads = 1;
+        parallel_for( 256, threads, [&]( unsigned d ) {
+            msd_sort( &buf[ offset[d] ], &buf[ offset[d + 1] ], k - 1 );
+            std::memcpy( first + offset[d], &buf[ offset[d] ], ( offset[d + 1] - offset[d] ) * sizeof(uuid) );
+        } );
+    }
+
+    // Time-ordered ids (v0/v1/v6/v7) only vary in a few bytes: LSD passes over just those
+    // bytes beat the MSD recursion, which pays a counting pass for every constant byte of
+    // every bucket. Random ids vary everywhere and keep the MSD path.
+    inline void sort( uuid *first, uuid *last ) {
+        size_t n = size_t( last - first );
+        if( n < 256 ) return std::sort( first, last );
+
+        uint64_t diff_ab = 0, diff_cd = 0;
+        size_t unsorted = 0;
+        for( uuid *p = first + 1; p < last; ++p ) {
+            diff_ab |= p->ab ^ first->ab, diff_cd |= p->cd ^ first->cd;
+            unsorted += *p < p[-1];
+        }
+        if( !unsorted ) return;
+
+        int digits[16], passes = 0;
+        for( int k = 0; k < 16; ++k )
+            if( ( k < 8 ? diff_cd >> ( 8 * k ) : diff_ab >> ( 8 * ( k - 8 ) ) ) & 0xFF ) digits[ passes++ ] = k;
+        if( passes > 6 ) return sort_parallel( first, last, 1 );
+
+        size_t count[6][256] = {};
+        for( uuid *p = first; p < last; ++p )
+            for( int i = 0; i < passes; ++i ) ++count[i][ radix_digit( *p, digits[i] ) ];
+
+        std::unique_ptr<uuid[]> buf( new uuid[n] );
+        uuid *src = first, *dst = buf.get();
+        for( int i = 0; i < passes; ++i ) {
+            size_t sum = 0;
+            for( int d = 0; d < 256; ++d ) { size_t c = count[i][d]; count[i][d] = sum, sum += c; }
+            for( uuid *p = src, *e = src + n; p < e; ++p ) dst[ count[i][ radix_digit( *p, digits[i] ) ]++ ] = *p;
+            std::swap( src, dst );
+        }
+        if( src != first ) std::memcpy( first, src, n * sizeof(uuid) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Binary layout
+
+    inline void store_be64( uint8_t *p, uint64_t v ) {
+        for( int i = 0; i < 8; ++i ) p[i] = uint8_t( v >> ( 56 - 8 * i ) );
+    }
+
+    inline uint64_t load_be64( const uint8_t *p ) {
+        uint64_t v = 0;
+        for( int i = 0; i < 8; ++i ) v = ( v << 8 ) | p[i];
+        return v;
+    }
+
+    // RFC <-> GUID byte order; self-inverse.
+    inline void guid_swap( uint8_t *b ) {
+        std::swap( b[0], b[3] ), std::swap( b[1], b[2] ), std::swap( b[4], b[5] ), std::swap( b[6], b[7] );
+    }
+
+    inline void to_bytes( const uuid &u, uint8_t out[16] ) {
+        store_be64( out + 0, u.ab );
+        store_be64( out + 8, u.cd );
+    }
+
+    inline uuid from_bytes( const uint8_t in[16] ) {
+        uuid u = { load_be64( in + 0 ), load_be64( in + 8 ) };
+        return u;
+    }
+
+    inline void to_guid_bytes( const uuid &u, uint8_t out[16] ) {
+        to_bytes( u, out );
+        guid_swap( out );
+    }
+
+    inline uuid from_guid_bytes( const uint8_t in[16] ) {
+        uint8_t b[16];
+        std::memcpy( b, in, 16 );
+        guid_swap( b );
+        return from_bytes( b );
+    }
+
+#if SOLE_SSSE3
+    // Permutes the bytes of each 16-byte record, out[j] = in[mask[j]] on the in-memory
+    // (little-endian) uuid. Returns how many records were done; the caller finishes the rest.
+    inline size_t shuffle_ids( const void *in, void *out, size_t n, const __m128i *mask, bool ids_in ) {
+        size_t i = 0;
+        const char *src = (const char *)in;
+        char *dst = (char *)out;
+#if SOLE_AVX2
+        const __m256i mask2 = _mm256_broadcastsi128_si256( _mm_loadu_si128( mask ) );
+        for( ; i + 2 <= n; i += 2 ) {
+            __m256i v = _mm256_loadu_si256( (const __m256i *)( src + 16 * i ) );
+            _mm256_storeu_si256( (__m256i *)( dst + 16 * i ), _mm256_shuffle_epi8( v, mask2 ) );
+        }
+#endif
+        const __m128i m = _mm_loadu_si128( mask );
+        for( ; i < n; ++i ) {
+#ifdef SOLE_ALIGN16
+            __m128i v = ids_in ? _mm_load_si128( (const __m128i *)( src + 16 * i ) ) : _mm_loadu_si128( (const __m128i *)( src + 16 * i ) );
+            v = _mm_shuffle_epi8( v, m );
+            if( ids_in ) _mm_storeu_si128( (__m128i *)( dst + 16 * i ), v );
+            else _mm_store_si128( (__m128i *)( dst + 16 * i ), v );
+#else
+            (void)ids_in;
+            _mm_storeu_si128( (__m128i *)( dst + 16 * i ), _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *)( src + 16 * i ) ), m ) );
+#endif
+        }
+        return i;
+    }
+
+    // pshufb masks from the in-memory uuid to wire/GUID bytes, and back
+    alignas(16) static const uint8_t wire_mask[16] = { 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 };
+    alignas(16) static const uint8_t guid_mask[16] = { 4, 5, 6, 7, 2, 3, 0, 1, 15, 14, 13, 12, 11, 10, 9, 8 };
+    alignas(16) static const uint8_t unguid_mask[16] = { 6, 7, 4, 5, 0, 1, 2, 3, 15, 14, 13, 12, 11, 10, 9, 8 };
+#endif
+
+    inline void to_bytes( const uuid *ids, size_t n, uint8_t *out ) {
+        size_t i = 0;
+#if SOLE_SSSE3
+        i = shuffle_ids( ids, out, n, (const __m128i *)wire_mask, true );
+#endif
+        for( ; i < n; ++i ) to_bytes( ids[i], out + 16 * i );
+    }
+
+    inline void from_bytes( const uint8_t *in, size_t n, uuid *out ) {
+        size_t i = 0;
+#if SOLE_SSSE3
+        i = shuffle_ids( in, out, n, (const __m128i *)wire_mask, false );
+#endif
+        for( ; i < n; ++i ) out[i] = from_bytes( in + 16 * i );
+    }
+
+    inline void to_guid_bytes( const uuid *ids, size_t n, uint8_t *out ) {
+        size_t i = 0;
+#if SOLE_SSSE3
+        i = shuffle_ids( ids, out, n, (const __m128i *)guid_mask, true );
+#endif
+        for( ; i < n; ++i ) to_guid_bytes( ids[i], out + 16 * i );
+    }
+
+    inline void from_guid_bytes( const uint8_t *in, size_t n, uuid *out ) {
+        size_t i = 0;
+#if SOLE_SSSE3
+        i = shuffle_ids( in, out, n, (const __m128i *)unguid_mask, false );
+#endif
+        for( ; i < n; ++i ) out[i] = from_guid_bytes( in + 16 * i );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Column codec
+
+    // Block layout, little-endian:
+    //   u32 block bytes (header included), u16 count, u8 mode
+    //   mode 0 (raw):  count * 16 wire bytes
+    //   mode 1 (time): u8 version, u8 flags (1: seq constant, 2: node constant),
+    //                  seq as 1 or count u16, node as 1 or count u48,
+    //                  varint first timestamp, then count-1 zigzag varint deltas
+    enum { column_header = 7, column_mode_raw = 0, column_mode_time = 1 };
+
+    inline void put_le( std::vector<uint8_t> &out, uint64_t v, int bytes ) {
+        for( int i = 0; i < bytes; ++i ) out.push_back( uint8_t( v >> ( 8 * i ) ) );
+    }
+
+    inline uint64_t get_le( const uint8_t *p, int bytes ) {
+        uint64_t v = 0;
+        for( int i = bytes; i--; ) v = ( v << 8 ) | p[i];
+        return v;
+    }
+
+    inline void put_varint( std::vector<uint8_t> &out, uint64_t v ) {
+        for( ; v >= 0x80; v >>= 7 ) out.push_back( uint8_t( v | 0x80 ) );
+        out.push_back( uint8_t( v ) );
+    }
+
+    inline bool get_varint( const uint8_t *&p, const uint8_t *end, uint64_t &v ) {
+        if( p < end && *p < 0x80 ) return v = *p++, true; // single byte: the common delta
+        v = 0;
+        for( int shift = 0; p < end && shift < 64; shift += 7 ) {
+            uint8_t b = *p++;
+            v |= uint64_t( b & 0x7F ) << shift;
+            if( b < 0x80 ) return true;
+        }
+        return false;
+    }
+
+    // 60-bit timestamp of a v0/v1/v6 id, and back
+    inline uint64_t column_time( uint64_t ab, unsigned version ) {
+        return version == 6 ? ( ( ab >> 16 ) << 12 ) | ( ab & 0xFFF )
+                            : ( ( ab & 0xFFF ) << 48 ) | ( ( ( ab >> 16 ) & 0xFFFF ) << 32 ) | ( ab >> 32 );
+    }
+
+    inline uint64_t column_ab( uint64_t t, unsigned version ) {
+        return version == 6 ? ( ( t >> 12 ) << 16 ) | 0x6000 | ( t & 0xFFF )
+                            : ( ( t & 0xFFFFFFFF ) << 32 ) | ( ( ( t >> 32 ) & 0xFFFF ) << 16 ) | ( version << 12 ) | ( t >> 48 );
+    }
+
+    inline void column_encoder::push( const uuid *ids, size_t n ) {
+        if( !pending.empty() ) {
+            size_t take = std::min( n, size_t( column_block ) - pending.size() );
+            pending.insert( pending.end(), ids, ids + take );
+            ids += take, n -= take;
+            if( pending.size() < column_block ) return;
+            encode_block( pending.data(), pending.size() );
+            pending.clear();
+        }
+        for( ; n >= column_block; ids += column_block, n -= column_block ) encode_block( ids, column_block );
+        pending.assign( ids, ids + n );
+    }
+
+    inline void column_encoder::finish() {
+        if( !pending.empty() ) encode_block( pending.data(), pending.size() );
+        pending.clear();
+    }
+
+    inline void column_encoder::encode_block( const uuid *ids, size_t n ) {
+        size_t at = out.size();
+        unsigned version = unsigned( ( ids[0].ab >> 12 ) & 0xF );
+        bool timed = version == 0 || version == 1 || version == 6, same_seq = true, same_node = true;
+        for( size_t i = 1; i < n && timed; ++i ) {
+            timed = ( ( ids[i].ab >> 12 ) & 0xF ) == version;
+            same_seq &= ( ids[i].cd >> 48 ) == ( ids[0].cd >> 48 );
+            same_node &= ( ids[i].cd << 16 ) == ( ids[0].cd << 16 );
+        }
+
+        put_le( out, 0, 4 ); // patched below
+        put_le( out, n, 2 );
+        if( !timed ) {
+            out.push_back( column_mode_raw );
+            out.resize( out.size() + 16 * n );
+            to_bytes( ids, n, &out[ out.size() - 16 * n ] );
+        } else {
+            out.push_back( column_mode_time );
+            out.push_back( uint8_t( version ) );
+            out.push_back( uint8_t( ( same_seq ? 1 : 0 ) | ( same_node ? 2 : 0 ) ) );
+            for( size_t i = 0, e = same_seq ? 1 : n; i < e; ++i ) put_le( out, ids[i].cd >> 48, 2 );
+            for( size_t i = 0, e = same_node ? 1 : n; i < e; ++i ) put_le( out, ids[i].cd, 6 );
+            uint64_t prev = column_time( ids[0].ab, version );
+            put_varint( out, prev );
+            for( size_t i = 1; i < n; ++i ) {
+                uint64_t t = column_time( ids[i].ab, version ), delta = t - prev;
+                put_varint( out, ( delta << 1 ) ^ uint64_t( int64_t( delta ) >> 63 ) ); // zigzag
+                prev = t;
+            }
+        }
+        uint64_t bytes = out.size() - at;
+        for( int i = 0; i < 4; ++i ) out[at + i] = uint8_t( bytes >> ( 8 * i ) );
+    }
+
+    inline column_decoder::column_decoder( const uint8_t *data_, size_t len ) : data( data_ ), valid( true ) {
+        uint64_t total = 0;
+        starts.push_back( 0 );
+        for( size_t at = 0; at < len; ) {
+            if( len - at < column_header ) { valid = false; break; }
+            uint64_t bytes = get_le( data + at, 4 ), n = get_le( data + at + 4, 2 );
+            if( bytes < column_header || bytes > len - at || !n || n > column_block ) { valid = false; break; }
+            offsets.push_back( at );
+            starts.push_back( total += n );
+            at += size_t( bytes );
+        }
+    }
+
+    inline size_t column_decoder::block_of( size_t i ) const {
+        return size_t( std::upper_bound( starts.begin(), starts.end(), uint64_t( i ) ) - starts.begin() ) - 1;
+    }
+
+    inline size_t column_decoder::decode_block( size_t block, uuid *out ) const {
+        if( block >= offsets.size() ) return 0;
+        const uint8_t *p = data + offsets[block], *end = p + get_le( p, 4 );
+        size_t n = size_t( get_le( p + 4, 2 ) );
+        unsigned mode = p[6];
+        p += column_header;
+
+        if( mode == column_mode_raw ) {
+            if( size_t( end - p ) != 16 * n ) return 0;
+            from_bytes( p, n, out );
+            return n;
+        }
+        if( mode != column_mode_time || end - p < 2 ) return 0;
+        unsigned version = p[0], flags = p[1];
+        if( ( version != 0 && version != 1 && version != 6 ) || flags > 3 ) return 0;
+        p += 2;
+        size_t seqs = flags & 1 ? 1 : n, nodes = flags & 2 ? 1 : n;
+        if( size_t( end - p ) < seqs * 2 + nodes * 6 ) return 0;
+        const uint8_t *seq = p, *node = p + seqs * 2;
+        p = node + nodes * 6;
+
+        uint64_t t;
+        if( !get_varint( p, end, t ) ) return 0;
+        uint64_t cd = ( get_le( seq, 2 ) << 48 ) | get_le( node, 6 );
+        out[0].ab = column_ab( t, version );
+        out[0].cd = cd;
+        for( size_t i = 1; i < n; ++i ) {
+            uint64_t z;
+            if( !get_varint( p, end, z ) ) return 0;
+            t += ( z >> 1 ) ^ ( 0 - ( z & 1 ) );
+            out[i].ab = column_ab( t, version );
+            out[i].cd = ( seqs == 1 && nodes == 1 ) ? cd
+                      : ( get_le( seq + 2 * ( seqs == 1 ? 0 : i ), 2 ) << 48 ) | get_le( node + 6 * ( nodes == 1 ? 0 : i ), 6 );
+        }
+        return p == end ? n : 0;
+    }
+
+    // All or nothing: salvage readable blocks of a damaged stream with decode_block().
+    inline bool column_decoder::decode( std::vector<uuid> &out ) const {
+        if( !valid ) return false;
+        size_t at = out.size();
+        out.resize( at + size() );
+        for( size_t b = 0; b < offsets.size(); ++b )
+            if( !decode_block( b, &out[ at + size_t( starts[b] ) ] ) ) return out.resize( at ), false;
+        return true;
+    }
+
+    inline uuid column_decoder::at( size_t i ) const {
+        uuid nil = { 0, 0 }, block[ column_block ];
+        if( i >= size() ) return nil;
+        size_t b = block_of( i );
+        return decode_block( b, block ) ? block[ i - size_t( starts[b] ) ] : nil;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Name-based UUIDs
+
+    inline uint32_t rotl32( uint32_t v, int r ) {
+        return ( v << r ) | ( v >> ( 32 - r ) );
+    }
+
+    inline uint32_t load_be32( const uint8_t *p ) {
+        return ( uint32_t( p[0] ) << 24 ) | ( uint32_t( p[1] ) << 16 ) | ( uint32_t( p[2] ) << 8 ) | p[3];
+    }
+
+    inline uint32_t load_le32( const uint8_t *p ) {
+        return ( uint32_t( p[3] ) << 24 ) | ( uint32_t( p[2] ) << 16 ) | ( uint32_t( p[1] ) << 8 ) | p[0];
+    }
+
+    // Word ops shared by the scalar and the 4-lane SSE2 hash kernels
+    inline uint32_t w_add( uint32_t a, uint32_t b ) { return a + b; }
+    inline uint32_t w_and( uint32_t a, uint32_t b ) { return a & b; }
+    inline uint32_t w_or( uint32_t a, uint32_t b ) { return a | b; }
+    inline uint32_t w_xor( uint32_t a, uint32_t b ) { return a ^ b; }
+    inline uint32_t w_andnot( uint32_t a, uint32_t b ) { return ~a & b; }
+    inline uint32_t w_not( uint32_t a ) { return ~a; }
+    template<int R> inline uint32_t w_rotl( uint32_t v ) { return ( v << R ) | ( v >> ( 32 - R ) ); }
+#if SOLE_SSE2
+    struct x4 { __m128i v; }; // four 32-bit lanes; wrapped, as vector types lose attributes as template arguments
+    inline x4 w_add( x4 a, x4 b ) { return x4{ _mm_add_epi32( a.v, b.v ) }; }
+    inline x4 w_add( x4 a, uint32_t k ) { return x4{ _mm_add_epi32( a.v, _mm_set1_epi32( int( k ) ) ) }; }
+    inline x4 w_and( x4 a, x4 b ) { return x4{ _mm_and_si128( a.v, b.v ) }; }
+    inline x4 w_or( x4 a, x4 b ) { return x4{ _mm_or_si128( a.v, b.v ) }; }
+    inline x4 w_xor( x4 a, x4 b ) { return x4{ _mm_xor_si128( a.v, b.v ) }; }
+    inline x4 w_andnot( x4 a, x4 b ) { return x4{ _mm_andnot_si128( a.v, b.v ) }; }
+    inline x4 w_not( x4 a ) { return x4{ _mm_xor_si128( a.v, _mm_set1_epi32( -1 ) ) }; }
+    template<int R> inline x4 w_rotl( x4 a ) { return x4{ _mm_or_si128( _mm_slli_epi32( a.v, R ), _mm_srli_epi32( a.v, 32 - R ) ) }; }
+    inline x4 w_set( uint32_t k ) { return x4{ _mm_set1_epi32( int( k ) ) }; }
+#endif
+
+    // MD5 per-round constants, shifts and message word
+    constexpr uint32_t md5_k[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+    };
+    constexpr int md5_shift( int i ) {
+        return i < 16 ? ( i % 4 == 0 ? 7 : i % 4 == 1 ? 12 : i % 4 == 2 ? 17 : 22 )
+             : i < 32 ? ( i % 4 == 0 ? 5 : i % 4 == 1 ?  9 : i % 4 == 2 ? 14 : 20 )
+             : i < 48 ? ( i % 4 == 0 ? 4 : i % 4 == 1 ? 11 : i % 4 == 2 ? 16 : 23 )
+             :          ( i % 4 == 0 ? 6 : i % 4 == 1 ? 10 : i % 4 == 2 ? 15 : 21 );
+    }
+    constexpr int md5_word( int i ) {
+        return i < 16 ? i : i < 32 ? ( 5 * i + 1 ) & 15 : i < 48 ? ( 3 * i + 5 ) & 15 : ( 7 * i ) & 15;
+    }
+
+    // Round I, then the rest. Registers rotate through the arguments instead of moving.
+    template<int I, typename T>
+    struct md5_rounds {
+        static inline void run( T &a, T &b, T &c, T &d, const T *w ) {
+            T f = I < 16 ? w_or( w_and( b, c ), w_andnot( b, d ) )
+                : I < 32 ? w_or( w_and( d, b ), w_andnot( d, c ) )
+                : I < 48 ? w_xor( w_xor( b, c ), d )
+                :          w_xor( c, w_or( b, w_not( d ) ) );
+            a = w_add( b, w_rotl<md5_shift( I )>( w_add( w_add( a, f ), w_add( w[ md5_word( I ) ], md5_k[I] ) ) ) );
+            md5_rounds<I + 1, T>::run( d, a, b, c, w );
+        }
+    };
+    template<typename T>
+    struct md5_rounds<64, T> {
+        static inline void run( T &, T &, T &, T &, const T * ) {}
+    };
+
+    constexpr uint32_t sha1_k( int i ) {
+        return i < 20 ? 0x5A827999 : i < 40 ? 0x6ED9EBA1 : i < 60 ? 0x8F1BBCDC : 0xCA62C1D6;
+    }
+
+    template<int I, typename T>
+    struct sha1_rounds {
+        static inline void run( T &a, T &b, T &c, T &d, T &e, T *w ) {
+            if( I >= 16 ) w[I & 15] = w_rotl<1>( w_xor( w_xor( w[( I - 3 ) & 15], w[( I - 8 ) & 15] ), w_xor( w[( I - 14 ) & 15], w[I & 15] ) ) );
+            T f = I < 20 ? w_or( w_and( b, c ), w_andnot( b, d ) )
+                : I < 40 || I >= 60 ? w_xor( w_xor( b, c ), d )
+                : w_or( w_and( b, c ), w_and( d, w_or( b, c ) ) );
+            e = w_add( w_add( w_rotl<5>( a ), f ), w_add( w_add( e, w[I & 15] ), sha1_k( I ) ) );
+            b = w_rotl<30>( b );
+            sha1_rounds<I + 1, T>::run( e, a, b, c, d, w );
+        }
+    };
+    template<typename T>
+    struct sha1_rounds<80, T> {
+        static inline void run( T &, T &, T &, T &, T &, T * ) {}
+    };
+
+    inline void md5_block( uint32_t h[4], const uint8_t block[64] ) {
+        uint32_t w[16];
+        for( int i = 0; i < 16; ++i ) w[i] = load_le32( block + 4 * i );
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3];
+        md5_rounds<0, uint32_t>::run( a, b, c, d, w );
+        h[0] += a, h[1] += b, h[2] += c, h[3] += d;
+    }
+
+    inline void sha1_block_scalar( uint32_t h[5], const uint8_t block[64] ) {
+        uint32_t w[16];
+        for( int i = 0; i < 16; ++i ) w[i] = load_be32( block + 4 * i );
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        sha1_rounds<0, uint32_t>::run( a, b, c, d, e, w );
+        h[0] += a, h[1] += b, h[2] += c, h[3] += d, h[4] += e;
+    }
+
+#if SOLE_SHA
+    // Four SHA-NI rounds (group J of 20) with the message schedule interleaved.
+    template<int J>
+    inline void sha1ni_rounds( __m128i &abcd, __m128i &e0, __m128i &e1, __m128i *m, const uint8_t *block ) {
+        const __m128i mask = _mm_set_epi64x( 0x0001020304050607LL, 0x08090a0b0c0d0e0fLL );
+        __m128i &cur = m[J % 4], &e = J % 2 ? e1 : e0, &next = J % 2 ? e0 : e1;
+        if( J < 4 ) cur = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *)( block + 16 * J ) ), mask );
+        e = J ? _mm_sha1nexte_epu32( e, cur ) : _mm_add_epi32( e, cur );
+        next = abcd;
+        if( J >= 3 && J <= 18 ) m[( J + 1 ) % 4] = _mm_sha1msg2_epu32( m[( J + 1 ) % 4], cur );
+        abcd = _mm_sha1rnds4_epu32( abcd, e, J / 5 );
+        if( J >= 1 && J <= 16 ) m[( J + 3 ) % 4] = _mm_sha1msg1_epu32( m[( J + 3 ) % 4], cur );
+        if( J >= 2 && J <= 17 ) m[( J + 2 ) % 4] = _mm_xor_si128( m[( J + 2 ) % 4], cur );
+        sha1ni_rounds<J + 1 < 20 ? J + 1 : 20>( abcd, e0, e1, m, block );
+    }
+    template<>
+    inline void sha1ni_rounds<20>( __m128i &, __m128i &, __m128i &, __m128i *, const uint8_t * ) {
+    }
+#endif
+
+    inline void sha1_block( uint32_t h[5], const uint8_t block[64] ) {
+#if SOLE_SHA
+        __m128i abcd = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i *)h ), 0x1B );
+        __m128i e0 = _mm_set_epi32( int( h[4] ), 0, 0, 0 ), e1, m[4];
+        __m128i abcd_save = abcd, e0_save = e0;
+        sha1ni_rounds<0>( abcd, e0, e1, m, block );
+        e0 = _mm_sha1nexte_epu32( e0, e0_save );
+        abcd = _mm_add_epi32( abcd, abcd_save );
+        _mm_storeu_si128( (__m128i *)h, _mm_shuffle_epi32( abcd, 0x1B ) );
+        h[4] = uint32_t( _mm_extract_epi32( e0, 3 ) );
+#else
+        sha1_block_scalar( h, block );
+#endif
+    }
+
+    // Hashes ns (wire order) followed by name, MD5 or SHA-1 padding.
+    template<typename BLOCK>
+    inline void name_hash( const uuid &ns, const char *name, size_t len, bool big_endian, uint32_t *h, const BLOCK &block ) {
+        uint8_t buf[128];
+        uint64_t bits = uint64_t( 16 + len ) * 8;
+        size_t fill = 16;
+        to_bytes( ns, buf );
+        for( ;; ) {
+            size_t take = std::min( len, 64 - fill );
+            std::memcpy( buf + fill, name, take );
+            name += take, len -= take, fill += take;
+            if( fill < 64 ) break;
+            block( h, buf );
+            fill = 0;
+        }
+        buf[fill++] = 0x80;
+        size_t total = fill <= 56 ? 64 : 128;
+        std::memset( buf + fill, 0, total - fill );
+        for( int i = 0; i < 8; ++i ) buf[total - 8 + i] = uint8_t( bits >> ( big_endian ? 56 - 8 * i : 8 * i ) );
+        block( h, buf );
+        if( total == 128 ) block( h, buf + 64 );
+    }
+
+    // First 128 bits of the digest, version and variant stamped.
+    inline uuid name_uuid( uint64_t ab, uint64_t cd, unsigned version ) {
+        uuid u;
+        u.ab = ( ab & 0xFFFFFFFFFFFF0FFFULL ) | ( uint64_t( version ) << 12 );
+        u.cd = ( cd & 0x3FFFFFFFFFFFFFFFULL ) | 0x8000000000000000ULL;
+        return u;
+    }
+
+    inline uuid md5_uuid( const uint32_t h[4] ) { // digest bytes are the little-endian words
+        uint8_t d[16];
+        for( int i = 0; i < 16; ++i ) d[i] = uint8_t( h[i / 4] >> ( 8 * ( i % 4 ) ) );
+        return name_uuid( load_be64( d ), load_be64( d + 8 ), 3 );
+    }
+
+    inline uuid sha1_uuid( const uint32_t h[5] ) { // digest bytes are the big-endian words
+        return name_uuid( ( uint64_t( h[0] ) << 32 ) | h[1], ( uint64_t( h[2] ) << 32 ) | h[3], 5 );
+    }
+
+    inline uuid md5_name( const uuid &ns, const char *name, size_t len ) {
+        uint32_t h[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+        name_hash( ns, name, len, false, h, md5_block );
+        return md5_uuid( h );
+    }
+
+    inline uuid sha1_name( const uuid &ns, const char *name, size_t len ) {
+        uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+        name_hash( ns, name, len, true, h, sha1_block );
+        return sha1_uuid( h );
+    }
+
+    inline uuid uuid3( const uuid &ns, const char *name, size_t len ) {
+        SOLE_EVENT( uuid3, 1 );
+        return md5_name( ns, name, len );
+    }
+
+    inline uuid uuid5( const uuid &ns, const char *name, size_t len ) {
+        SOLE_EVENT( uuid5, 1 );
+        return sha1_name( ns, name, len );
+    }
+
+    inline uuid uuid3( const uuid &ns, const std::string &name ) {
+        return uuid3( ns, name.data(), name.size() );
+    }
+
+    inline uuid uuid5( const uuid &ns, const std::string &name ) {
+        return uuid5( ns, name.data(), name.size() );
+    }
+
+    enum { name_lanes = 4, name_short = 64 - 16 - 1 - 8 }; // longest name fitting one block
+
+#if SOLE_SSE2
+    // Transposes 4 single-block messages: w[i] holds message word i of every lane.
+    inline void name_lanes_load( const uuid &ns, const std::string *const *names, bool big_endian, x4 w[16] ) {
+        alignas(16) uint32_t words[16][ name_lanes ];
+        for( int l = 0; l < name_lanes; ++l ) {
+            uint8_t buf[64] = {};
+            size_t len = names[l]->size();
+            uint64_t bits = uint64_t( 16 + len ) * 8;
+            to_bytes( ns, buf );
+            std::memcpy( buf + 16, names[l]->data(), len );
+            buf[16 + len] = 0x80;
+            for( int i = 0; i < 8; ++i ) buf[56 + i] = uint8_t( bits >> ( big_endian ? 56 - 8 * i : 8 * i ) );
+            for( int i = 0; i < 16; ++i ) words[i][l] = big_endian ? load_be32( buf + 4 * i ) : load_le32( buf + 4 * i );
+        }
+        for( int i = 0; i < 16; ++i ) w[i].v = _mm_load_si128( (const __m128i *)words[i] );
+    }
+
+    // Adds the initial state back and splits the lanes; h[4] is 0 (unused by v5) for MD5.
+    inline void name_lanes_store( const x4 *state, const uint32_t *iv, uuid *out, uuid (*make)( const uint32_t * ) ) {
+        alignas(16) uint32_t h[4][ name_lanes ];
+        for( int i = 0; i < 4; ++i ) _mm_store_si128( (__m128i *)h[i], w_add( state[i], iv[i] ).v );
+        for( int l = 0; l < name_lanes; ++l ) {
+            uint32_t lane[5] = { h[0][l], h[1][l], h[2][l], h[3][l], 0 };
+            out[l] = make( lane );
+        }
+    }
+
+    // MD5 of 4 single-block names at once, one lane per name.
+    inline void md5_x4( const uuid &ns, const std::string *const *names, uuid *out ) {
+        static const uint32_t iv[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+        x4 w[16], h[4];
+        name_lanes_load( ns, names, false, w );
+        for( int i = 0; i < 4; ++i ) h[i] = w_set( iv[i] );
+        md5_rounds<0, x4>::run( h[0], h[1], h[2], h[3], w );
+        name_lanes_store( h, iv, out, md5_uuid );
+    }
+
+    // SHA-1 of 4 single-block names at once, one lane per name. Only 128 of the 160
+    // digest bits make it into the uuid, so e is not finalized.
+    inline void sha1_x4( const uuid &ns, const std::string *const *names, uuid *out ) {
+        static const uint32_t iv[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+        x4 w[16], h[5];
+        name_lanes_load( ns, names, true, w );
+        for( int i = 0; i < 5; ++i ) h[i] = w_set( iv[i] );
+        sha1_rounds<0, x4>::run( h[0], h[1], h[2], h[3], h[4], w );
+        name_lanes_store( h, iv, out, sha1_uuid );
+    }
+#endif
+
+#if SOLE_SSE2
+    // Groups short names four at a time for the SIMD kernel; long ones go one by one.
+    template<typename KERNEL, typename ONE>
+    inline void name_uuid_n( const uuid &ns, const std::string *names, size_t n, uuid *out, const KERNEL &kernel, const ONE &one ) {
+        const std::string *lane[ name_lanes ];
+        size_t slot[ name_lanes ], filled = 0;
+        uuid ids[ name_lanes ];
+        for( size_t i = 0; i < n; ++i ) {
+            if( names[i].size() > name_short ) {
+                out[i] = one( ns, names[i].data(), names[i].size() );
+                continue;
+            }
+            lane[filled] = &names[i], slot[filled++] = i;
+            if( filled == name_lanes ) {
+                kernel( ns, lane, ids );
+                for( size_t l = 0; l < name_lanes; ++l ) out[ slot[l] ] = ids[l];
+                filled = 0;
+            }
+        }
+        for( size_t l = 0; l < filled; ++l ) out[ slot[l] ] = one( ns, lane[l]->data(), lane[l]->size() );
+    }
+#endif
+
+    inline void uuid3_n( const uuid &ns, const std::string *names, size_t n, uuid *out ) {
+        SOLE_EVENT( uuid3, n );
+#if SOLE_SSE2
+        name_uuid_n( ns, names, n, out, md5_x4, md5_name );
+#else
+        for( size_t i = 0; i < n; ++i ) out[i] = md5_name( ns, names[i].data(), names[i].size() );
+#endif
+    }
+
+    inline void uuid5_n( const uuid &ns, const std::string *names, size_t n, uuid *out ) {
+        SOLE_EVENT( uuid5, n );
+#if SOLE_SSE2 && !SOLE_SHA // one SHA-NI block beats four lanes of SSE2
+        name_uuid_n( ns, names, n, out, sha1_x4, sha1_name );
+#else
+        for( size_t i = 0; i < n; ++i ) out[i] = sha1_name( ns, names[i].data(), names[i].size() );
+#endif
+    }
+
+    inline std::vector<uuid> uuid3_n( const uuid &ns, const std::vector<std::string> &names ) {
+        std::vector<uuid> v( names.size() );
+        uuid3_n( ns, names.data(), names.size(), v.data() );
+        return v;
+    }
+
+    inline std::vector<uuid> uuid5_n( const uuid &ns, const std::vector<std::string> &names ) {
+        std::vector<uuid> v( names.size() );
+        uuid5_n( ns, names.data(), names.size(), v.data() );
+        return v;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Pool
+
+    inline uuid generate( unsigned version ) {
+        switch( version ) {
+            case 0: return uuid0();
+            case 1: return uuid1();
+            case 6: return uuid6();
+            case 7: return uuid7();
+            default: return uuid4();
+        }
+    }
+
+    inline void generate_n( unsigned version, uuid *out, size_t n ) {
+        switch( version ) {
+            case 0: return uuid0_n( out, n );
+            case 1: return uuid1_n( out, n );
+            case 6: return uuid6_n( out, n );
+            case 7: return uuid7_n( out, n );
+            default: return uuid4_n( out, n );
+        }
+    }
+
+    // Bounded MPMC queue (Vyukov). Every cell carries a sequence number that tells whose
+    // turn it is: pos for the producer, pos + 1 for the consumer, so push and pop are one
+    // CAS each. Head and tail sit on their own cache lines, and count every pop and push
+    // ever made, so they double as the hit and refill counters.
+    struct pool_ring {
+        struct cell {
+            std::atomic<size_t> seq;
+            uuid id;
+        };
+
+        std::unique_ptr<cell[]> cells;
+        size_t mask;
+        char pad0[64];
+        std::atomic<size_t> head; // next pop
+        char pad1[64];
+        std::atomic<size_t> tail; // next push
+        char pad2[64];
+        std::atomic<uint64_t> misses;
+        char pad3[64];
+
+        void init( size_t capacity ) {
+            cells.reset( new cell[ capacity ] );
+            mask = capacity - 1;
+            for( size_t i = 0; i < capacity; ++i ) cells[i].seq.store( i, std::memory_order_relaxed );
+            head.store( 0, std::memory_order_relaxed );
+            tail.store( 0, std::memory_order_relaxed );
+            misses.store( 0, std::memory_order_relaxed );
+        }
+
+        bool push( const uuid &u ) {
+            size_t pos = tail.load( std::memory_order_relaxed );
+            for( ;; ) {
+                cell &c = cells[ pos & mask ];
+                intptr_t dif = intptr_t( c.seq.load( std::memory_order_acquire ) ) - intptr_t( pos );
+                if( dif < 0 ) return false; // full
+                if( dif == 0 && tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                    c.id = u;
+                    c.seq.store( pos + 1, std::memory_order_release );
+                    return true;
+                }
+                if( dif > 0 ) pos = tail.load( std::memory_order_relaxed );
+            }
+        }
+
+        bool pop( uuid &u ) {
+            size_t pos = head.load( std::memory_order_relaxed );
+            for( ;; ) {
+                cell &c = cells[ pos & mask ];
+                intptr_t dif = intptr_t( c.seq.load( std::memory_order_acquire ) ) - intptr_t( pos + 1 );
+                if( dif < 0 ) return false; // empty
+                if( dif == 0 && head.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                    u = c.id;
+                    c.seq.store( pos + mask + 1, std::memory_order_release );
+                    return true;
+                }
+                if( dif > 0 ) pos = head.load( std::memory_order_relaxed );
+            }
+        }
+
+        size_t fill() const {
+            size_t h = head.load( std::memory_order_relaxed ), t = tail.load( std::memory_order_relaxed );
+            return t > h ? t - h : 0;
+        }
+    };
+
+    struct pool::state {
+        enum : unsigned { supported = 1u << 0 | 1u << 1 | 1u << 4 | 1u << 6 | 1u << 7 };
+
+        // Threads do not survive fork() and the child may inherit the mutex locked, so the
+        // child abandons this and builds a new one.
+        struct refiller {
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::thread thread;
+        };
+
+        pool_ring rings[8]; // by version
+        unsigned versions;
+        size_t capacity, low_water;
+        std::atomic<unsigned> generation; // fork generation the rings belong to
+        std::atomic<unsigned> claimed;    // fork generation being (or already) set up
+        std::atomic<bool> hungry, stop;
+        refiller *worker;
+
+        void start() {
+            for( unsigned v = 0; v < 8; ++v ) if( versions >> v & 1 ) rings[v].init( capacity );
+            hungry.store( true, std::memory_order_relaxed );
+            stop.store( false, std::memory_order_relaxed );
+            worker = new refiller;
+            worker->thread = std::thread( [this]() { run(); } );
+        }
+
+        void run() {
+            enum { batch = 256 };
+            uuid ids[ batch ];
+            refiller &w = *worker;
+            for( ;; ) {
+                {
+                    std::unique_lock<std::mutex> lock( w.mutex );
+                    w.wake.wait( lock, [this]() { return stop.load() || hungry.load(); } );
+                }
+                if( stop.load() ) return;
+                hungry.store( false );
+                for( unsigned v = 0; v < 8; ++v ) {
+                    if( !( versions >> v & 1 ) ) continue;
+                    pool_ring &r = rings[v];
+                    for( size_t fill; !stop.load( std::memory_order_relaxed ) && ( fill = r.fill() ) < capacity; ) {
+                        size_t n = std::min<size_t>( batch, capacity - fill ), pushed = 0;
+                        generate_n( v, ids, n );
+                        while( pushed < n && r.push( ids[pushed] ) ) ++pushed;
+                        if( pushed < n ) break; // consumers are slower than us: drop the rest
+                    }
+                }
+            }
+        }
+
+        void feed() {
+            if( hungry.exchange( true ) ) return;
+            std::lock_guard<std::mutex> lock( worker->mutex );
+            worker->wake.notify_one();
+        }
+
+        // In the child after fork(): the rings hold ids the parent also hands out.
+        // First caller rebuilds everything, concurrent callers generate inline meanwhile.
+        void after_fork( unsigned g ) {
+            unsigned c = claimed.load();
+            if( c == g || !claimed.compare_exchange_strong( c, g ) ) return;
+            worker = 0; // leaked on purpose: owned by a thread that no longer exists
+            start();
+            generation.store( g, std::memory_order_release );
+        }
+    };
+
+    inline pool::pool( unsigned versions, size_t capacity, size_t low_water ) : self( new state ) {
+        size_t cap = 64;
+        while( cap < capacity ) cap <<= 1;
+        self->versions = versions & state::supported;
+        self->capacity = cap;
+        self->low_water = std::min( cap, low_water ? low_water : cap / 2 );
+        unsigned g = fork_generation(); // installs the fork handler too
+        self->generation.store( g );
+        self->claimed.store( g );
+        self->start();
+    }
+
+    inline pool::~pool() {
+        if( self->generation.load() == fork_generation() && self->worker ) {
+            {
+                std::lock_guard<std::mutex> lock( self->worker->mutex );
+                self->stop.store( true );
+                self->worker->wake.notify_one();
+            }
+            self->worker->thread.join();
+            delete self->worker;
+        }
+        delete self;
+    }
+
+    inline uuid pool::take( unsigned version ) {
+        state &s = *self;
+        if( version >= 8 || !( s.versions >> version & 1 ) ) return generate( version );
+
+        pool_ring &r = s.rings[ version ];
+        unsigned g = fork_counter().load( std::memory_order_relaxed );
+        if( s.generation.load( std::memory_order_acquire ) != g ) {
+            s.after_fork( g );
+        } else {
+            uuid u;
+            if( r.pop( u ) ) {
+                if( r.fill() < s.low_water ) s.feed();
+                return u;
+            }
+            s.feed();
+        }
+        r.misses.fetch_add( 1, std::memory_order_relaxed );
+        return generate( version );
+    }
+
+    inline pool::counters pool::stats( unsigned version ) const {
+        counters c = { 0, 0, 0, 0 };
+        const state &s = *self;
+        if( version >= 8 || !( s.versions >> version & 1 ) || s.generation.load( std::memory_order_acquire ) != fork_generation() ) return c;
+        const pool_ring &r = s.rings[ version ];
+        c.fill = r.fill();
+        c.hits = r.head.load( std::memory_order_relaxed );
+        c.misses = r.misses.load( std::memory_order_relaxed );
+        c.refills = r.tail.load( std::memory_order_relaxed );
+        return c;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Deterministic generator
+
+    inline deterministic_generator::deterministic_generator( uint64_t seed, uint64_t start, uint64_t step_ )
+        : clock( start ), step( step_ ? step_ : 1 ), v7_ms( 0 ), v7_counter( 0 ) {
+        for( auto &w : s ) w = splitmix64( seed );
+        redraw_identity();
+    }
+
+    inline uint64_t deterministic_generator::next() {
+        auto rotl = []( uint64_t x, int k ) { return ( x << k ) | ( x >> ( 64 - k ) ); };
+        uint64_t result = rotl( s[1] * 5, 7 ) * 9, t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl( s[3], 45 );
+        return result;
+    }
+
+    inline void deterministic_generator::jump() {
+        static const uint64_t poly[4] = { 0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+        uint64_t j[4] = { 0, 0, 0, 0 };
+        for( uint64_t word : poly )
+            for( int b = 0; b < 64; ++b ) {
+                if( word >> b & 1 ) for( int i = 0; i < 4; ++i ) j[i] ^= s[i];
+                next();
+            }
+        for( int i = 0; i < 4; ++i ) s[i] = j[i];
+        redraw_identity();
+    }
+
+    // Random node with the multicast bit set, as RFC 9562 asks of nodes that are not MACs.
+    inline void deterministic_generator::redraw_identity() {
+        uint64_t r = next();
+        node = ( r & 0xFFFFFFFFFFFFULL ) | 0x010000000000ULL;
+        clock_seq = uint16_t( ( r >> 48 ) & 0x3fff );
+        pid = uint16_t( next() );
+    }
+
+    inline uint64_t deterministic_generator::tick() {
+        uint64_t t = clock;
+        clock += step;
+        return t;
+    }
+
+    inline uuid deterministic_generator::uuid0() {
+        return make_uuid0( tick(), pid, node );
+    }
+
+    inline uuid deterministic_generator::uuid1() {
+        return make_uuid1( tick() + 0x01b21dd213814000ULL, clock_seq, node );
+    }
+
+    inline uuid deterministic_generator::uuid6() {
+        uuid u = uuid1();
+        u.ab = v1_ab_to_v6( u.ab );
+        return u;
+    }
+
+    inline uuid deterministic_generator::uuid4() {
+        uuid u = { next(), next() };
+        u.ab = ( u.ab & 0xFFFFFFFFFFFF0FFFULL ) | 0x0000000000004000ULL;
+        u.cd = ( u.cd & 0x3FFFFFFFFFFFFFFFULL ) | 0x8000000000000000ULL;
+        return u;
+    }
+
+    inline void deterministic_generator::uuid4_n( uuid *out, size_t n ) {
+        for( size_t i = 0; i < n; ++i ) out[i] = uuid4();
+    }
+
+    // Same counter scheme as uuid7_state, drawing from this generator.
+    inline uuid deterministic_generator::uuid7() {
+        uint64_t ms = tick() / 10000;
+        if( ms > v7_ms ) {
+            v7_ms = ms;
+            v7_counter = next() & 0x1FFFFFFFFFFULL;
+        }
+        else if( ++v7_counter >> 42 ) {
+            ++v7_ms;
+            v7_counter = next() & 0x1FFFFFFFFFFULL;
+        }
+        return make_uuid7( v7_ms, v7_counter, uint32_t( next() ) );
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Time index
+
+    inline time_index::time_index( const uuid *ids_, size_t n_, size_t stride_ )
+        : ids( ids_ ), n( n_ ), stride( stride_ ? stride_ : 1 ), valid( true ) {
+        marks.reserve( ( n + stride - 1 ) / stride );
+        for( size_t i = 0; i < n; i += stride ) {
+            uint64_t t = timestamp_of( ids[i] );
+            valid &= marks.empty() || marks.back() <= t;
+            marks.push_back( t );
+        }
+    }
+
+    inline size_t time_index::lower_bound( uint64_t t ) const {
+        // first sampled id at or after t; the answer lies after the previous sample
+        size_t k = size_t( std::lower_bound( marks.begin(), marks.end(), t ) - marks.begin() );
+        if( !k ) return 0;
+        size_t lo = ( k - 1 ) * stride + 1, hi = std::min( k * stride, n );
+        while( lo < hi ) {
+            size_t mid = lo + ( hi - lo ) / 2;
+            if( timestamp_of( ids[mid] ) < t ) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    inline std::pair<size_t, size_t> time_index::range( uint64_t t0, uint64_t t1 ) const {
+        if( t1 <= t0 ) return std::make_pair( size_t( 0 ), size_t( 0 ) );
+        return std::make_pair( lower_bound( t0 ), lower_bound( t1 ) );
+    }
+
+} // ::sole
+
+#undef $bsd
+#undef $belse
+#undef $linux
+#undef $lelse
+#undef $osx
+#undef $oelse
+#undef $unix
+#undef $uelse
+#undef $windows
+#undef $welse
+#undef $yes
+#undef $no
+
+// Pop disabled warnings
+#if (defined(__APPLE__) && defined(__MACH__))
+#pragma clang diagnostic pop
+#endif
+
+#ifdef SOLE_BUILD_DEMO
+// g++ users: `g++ demo.cc -std=c++11 -lrt -o sample`
+// visual studio: `cl.exe demo.cc sole.cpp`
+
+#include <iostream>
+
+int main() {
+    sole::uuid u0 = sole::uuid0(), u1 = sole::uuid1(), u4 = sole::uuid4(), u7 = sole::uuid7();
+
+    std::cout << "uuid v0 string : " << u0 << std::endl;
+    std::cout << "uuid v0 base62 : " << u0.base62() << std::endl;
+    std::cout << "uuid v0 pretty : " << u0.pretty() << std::endl << std::endl;
+
+    std::cout << "uuid v1 string : " << u1 << std::endl;
+    std::cout << "uuid v1 base62 : " << u1.base62() << std::endl;
+    std::cout << "uuid v1 pretty : " << u1.pretty() << std::endl << std::endl;
+
+    std::cout << "uuid v4 string : " << u4 << std::endl;
+    std::cout << "uuid v4 base62 : " << u4.base62() << std::endl;
+    std::cout << "uuid v4 pretty : " << u4.pretty() << std::endl << std::endl;
+
+    std::cout << "uuid v7 string : " << u7 << std::endl;
+    std::cout << "uuid v7 base62 : " << u7.base62() << std::endl;
+    std::cout << "uuid v7 pretty : " << u7.pretty() << std::endl << std::endl;
+
+    u1 = sole::rebuild("F81D4FAE-7DEC-11D0-A765-00A0C91E6BF6");
+    u4 = sole::rebuild("GITheR4tLlg-BagIW20DGja");
+
+    std::cout << "uuid v1 rebuilt : " << u1 << " -> " << u1.pretty() << std::endl;
+    std::cout << "uuid v4 rebuilt : " << u4 << " -> " << u4.pretty() << std::endl;
+}
+
+#endif
+
+#ifdef SOLE_BUILD_BENCH
+// g++ users: `g++ bench.cc -std=c++11 -O2 -pthread -lrt -o bench`
+// visual studio: `cl.exe /O2 bench.cc`
+// usage: bench [--json] [--threads N] [name filter]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench
+{
+    typedef std::chrono::steady_clock timer;
+
+    // Makes the compiler assume `v` is read, so the work producing it cannot be dropped.
+    template<typename T>
+    inline void keep( const T &v ) {
+#if defined(_MSC_VER)
+        static const void *volatile escape;
+        escape = &v;
+        _ReadWriteBarrier();
+#else
+        asm volatile( "" : : "m"( v ) : "memory" );
+#endif
+    }
+
+    struct result {
+        std::string name;
+        unsigned threads;
+        double median_ns, p99_ns; // per operation, over all samples of all threads
+        double mops;              // million operations per second, all threads together
+    };
+
+    enum { samples = 200, sample_us = 20 };
+
+    // Calls per sample so that one sample lasts about sample_us.
+    template<typename FN>
+    inline size_t calibrate( const FN &fn ) {
+        size_t batch = 1;
+        for( ; batch < ( size_t(1) << 24 ); batch *= 2 ) {
+            auto then = timer::now();
+            for( size_t i = 0; i < batch; ++i ) fn( i );
+            if( timer::now() - then >= std::chrono::microseconds( sample_us ) ) break;
+        }
+        return batch;
+    }
+
+    // Every thread times `samples` batches of fn(i). `per_call` operations happen per call.
+    template<typename FN>
+    inline result measure( const std::string &name, const FN &fn, unsigned threads, unsigned per_call ) {
+        size_t batch = calibrate( fn );
+        std::vector<double> ns( size_t( samples ) * threads );
+        std::atomic<unsigned> ready( 0 );
+        std::atomic<bool> go( false );
+
+        auto worker = [&]( unsigned t ) {
+            ++ready;
+            while( !go ) std::this_thread::yield();
+            for( size_t s = 0; s < samples; ++s ) {
+                auto then = timer::now();
+                for( size_t i = 0; i < batch; ++i ) fn( s * batch + i );
+                ns[ t * samples + s ] = std::chrono::duration<double, std::nano>( timer::now() - then ).count() / ( batch * per_call );
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for( unsigned t = 1; t < threads; ++t ) pool.emplace_back( worker, t );
+        while( ready < threads - 1 ) std::this_thread::yield();
+        auto then = timer::now();
+        go = true;
+        worker( 0 );
+        for( auto &th : pool ) th.join();
+        double wall_us = std::chrono::duration<double, std::micro>( timer::now() - then ).count();
+
+        std::sort( ns.begin(), ns.end() );
+        result r = { name, threads, ns[ ns.size() / 2 ], ns[ ns.size() * 99 / 100 ], 0 };
+        r.mops = double( batch ) * double( samples ) * threads * per_call / wall_us;
+        return r;
+    }
+
+    struct op {
+        std::string name;
+        std::function<result( unsigned threads )> run;
+    };
+
+    template<typename FN>
+    inline op make( const std::string &name, const FN &fn, unsigned per_call = 1 ) {
+        op o = { name, [=]( unsigned threads ) { return measure( name, fn, threads, per_call ); } };
+        return o;
+    }
+
+    // Same as make(), timed with the given clock source selected.
+    template<typename FN>
+    inline op make_clocked( const std::string &name, sole::clock_source src, const FN &fn ) {
+        op o = { name, [=]( unsigned threads ) {
+            sole::set_clock_source( src );
+            for( auto end = timer::now() + std::chrono::milliseconds( 20 ); timer::now() < end; ) keep( sole::clock_drift() ); // tsc calibrates
+            result r = measure( name, fn, threads, 1 );
+            sole::set_clock_source( sole::clock_realtime );
+            return r;
+        } };
+        return o;
+    }
+
+    // Mean and worst distance between a clock source and CLOCK_REALTIME, in ns, sampled
+    // over about 100 ms of mixed id generation and idling.
+    inline void drift( sole::clock_source src, double &mean_ns, double &worst_ns ) {
+        sole::set_clock_source( src );
+        double sum = 0, worst = 0;
+        enum { rounds = 500 };
+        for( int i = 0; i < rounds; ++i ) {
+            for( int j = 0; j < 100; ++j ) keep( sole::uuid1() );
+            double d = std::fabs( double( sole::clock_drift() ) * 100 );
+            sum += d, worst = std::max( worst, d );
+            std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+        }
+        sole::set_clock_source( sole::clock_realtime );
+        mean_ns = sum / double( rounds ), worst_ns = worst;
+    }
+}
+
+int main( int argc, char **argv ) {
+    using bench::keep;
+    bool json = false;
+    unsigned max_threads = std::max( 1u, std::thread::hardware_concurrency() );
+    std::string filter;
+    for( int i = 1; i < argc; ++i ) {
+        if( !strcmp( argv[i], "--json" ) ) json = true;
+        else if( !strcmp( argv[i], "--threads" ) && i + 1 < argc ) max_threads = std::max( 1, atoi( argv[++i] ) );
+        else filter = argv[i];
+    }
+
+    // Shared read-only inputs, indexed by call number so nothing is loop-invariant
+    enum { inputs = 1024, mask = inputs - 1, batch = 64 };
+    std::vector<sole::uuid> v1 = sole::uuid1_n( inputs ), v4 = sole::uuid4_n( inputs );
+    std::vector<std::string> hex( inputs ), b62( inputs ), names( inputs );
+    for( size_t i = 0; i < inputs; ++i ) {
+        hex[i] = v4[i].str();
+        b62[i] = v4[i].base62();
+        names[i] = "host-" + std::to_string( i ) + ".example.com";
+    }
+    sole::keyed_hash keyed;
+    sole::pool pool( 1u << 4, 1 << 16 );
+    std::vector<sole::uuid> ordered = sole::uuid1_n( 1 << 20 ); // consecutive ticks
+    std::vector<uint64_t> stamps( inputs );
+    for( size_t i = 0; i < inputs; ++i ) stamps[i] = sole::decode( ordered[ i * 1021 ] ).timestamp;
+    sole::time_index index( ordered.data(), ordered.size() );
+
+    std::vector<bench::op> ops = {
+        bench::make( "uuid0", []( size_t ) { keep( sole::uuid0() ); } ),
+        bench::make( "uuid1", []( size_t ) { keep( sole::uuid1() ); } ),
+        bench::make_clocked( "uuid1 (coarse clock)", sole::clock_coarse, []( size_t ) { keep( sole::uuid1() ); } ),
+        bench::make_clocked( "uuid1 (tsc clock)", sole::clock_tsc, []( size_t ) { keep( sole::uuid1() ); } ),
+        bench::make( "uuid4", []( size_t ) { keep( sole::uuid4() ); } ),
+        bench::make( "uuid6", []( size_t ) { keep( sole::uuid6() ); } ),
+        bench::make( "uuid7", []( size_t ) { keep( sole::uuid7() ); } ),
+        bench::make( "uuid3", [&]( size_t i ) { keep( sole::uuid3( sole::ns_dns, names[i & mask] ) ); } ),
+        bench::make( "uuid5", [&]( size_t i ) { keep( sole::uuid5( sole::ns_dns, names[i & mask] ) ); } ),
+        bench::make( "pool take (v4)", [&]( size_t ) { keep( pool.take( 4 ) ); } ),
+        bench::make( "uuid4 (deterministic)", []( size_t ) { static thread_local sole::deterministic_generator g( 1 ); keep( g.uuid4() ); } ),
+        bench::make( "uuid1 (deterministic)", []( size_t ) { static thread_local sole::deterministic_generator g( 1 ); keep( g.uuid1() ); } ),
+        bench::make( "uuid4 (random_device)", []( size_t ) { keep( sole::os_random64() ); keep( sole::os_random64() ); } ),
+        bench::make( "uuid0_n", []( size_t ) { sole::uuid ids[batch]; sole::uuid0_n( ids, batch ); keep( ids ); }, batch ),
+        bench::make( "uuid1_n", []( size_t ) { sole::uuid ids[batch]; sole::uuid1_n( ids, batch ); keep( ids ); }, batch ),
+        bench::make( "uuid4_n", []( size_t ) { sole::uuid ids[batch]; sole::uuid4_n( ids, batch ); keep( ids ); }, batch ),
+        bench::make( "uuid7_n", []( size_t ) { sole::uuid ids[batch]; sole::uuid7_n( ids, batch ); keep( ids ); }, batch ),
+        bench::make( "uuid3_n", [&]( size_t i ) { sole::uuid ids[batch]; sole::uuid3_n( sole::ns_dns, &names[ i * batch & mask ], batch, ids ); keep( ids ); }, batch ),
+        bench::make( "uuid5_n", [&]( size_t i ) { sole::uuid ids[batch]; sole::uuid5_n( sole::ns_dns, &names[ i * batch & mask ], batch, ids ); keep( ids ); }, batch ),
+        bench::make( "str", [&]( size_t i ) { keep( v4[i & mask].str() ); } ),
+        bench::make( "write_str", [&]( size_t i ) { char buf[ sole::uuid::str_size ]; v4[i & mask].write_str( buf ); keep( buf ); } ),
+        bench::make( "base62", [&]( size_t i ) { keep( v4[i & mask].base62() ); } ),
+        bench::make( "base62 (fixed)", [&]( size_t i ) { keep( v4[i & mask].base62( true ) ); } ),
+        bench::make( "write_base62", [&]( size_t i ) { char buf[ sole::uuid::base62_max_size ]; v4[i & mask].write_base62( buf ); keep( buf ); } ),
+        bench::make( "rebuild (hex)", [&]( size_t i ) { keep( sole::rebuild( hex[i & mask] ) ); } ),
+        bench::make( "rebuild (base62)", [&]( size_t i ) { keep( sole::rebuild( b62[i & mask] ) ); } ),
+        bench::make( "parse (hex)", [&]( size_t i ) { sole::uuid u; keep( sole::parse( hex[i & mask].data(), hex[i & mask].size(), u ) ); keep( u ); } ),
+        bench::make( "parse (base62)", [&]( size_t i ) { sole::uuid u; keep( sole::parse( b62[i & mask].data(), b62[i & mask].size(), u ) ); keep( u ); } ),
+        bench::make( "pretty", [&]( size_t i ) { keep( v1[i & mask].pretty() ); } ),
+        bench::make( "pretty (utc)", [&]( size_t i ) { keep( v1[i & mask].pretty( true ) ); } ),
+        bench::make( "decode", [&]( size_t i ) { keep( sole::decode( v1[i & mask] ) ); } ),
+        bench::make( "extract_timestamps", [&]( size_t i ) { uint64_t t[batch]; sole::extract_timestamps( &v1[ i * batch & mask ], batch, t ); keep( t ); }, batch ),
+        bench::make( "time_index range", [&]( size_t i ) { keep( index.range( stamps[i & mask], stamps[i & mask] + 1000 ) ); } ),
+        bench::make( "to_bytes", [&]( size_t i ) { uint8_t b[16]; sole::to_bytes( v4[i & mask], b ); keep( b ); } ),
+        bench::make( "hash (mix)", [&]( size_t i ) { keep( sole::mix_hash()( v4[i & mask] ) ); } ),
+        bench::make( "hash (keyed)", [&]( size_t i ) { keep( keyed( v4[i & mask] ) ); } ),
+        bench::make( "hash (xor)", [&]( size_t i ) { keep( sole::xor_hash()( v4[i & mask] ) ); } ),
+        bench::make( "operator<", [&]( size_t i ) { keep( v4[i & mask] < v4[( i + 1 ) & mask] ); } ),
+        bench::make( "operator==", [&]( size_t i ) { keep( v4[i & mask] == v4[( i + 1 ) & mask] ); } ),
+    };
+
+    std::vector<unsigned> thread_counts;
+    for( unsigned t = 1; t < max_threads; t *= 2 ) thread_counts.push_back( t );
+    thread_counts.push_back( max_threads );
+
+    bool first = true;
+    if( json ) printf( "{\n  \"version\": \"%s\",\n  \"results\": [", SOLE_VERSION );
+    for( auto &o : ops ) {
+        if( !filter.empty() && o.name.find( filter ) == std::string::npos ) continue;
+        for( unsigned t : thread_counts ) {
+            bench::result r = o.run( t );
+            if( json ) {
+                printf( "%s\n    { \"name\": \"%s\", \"threads\": %u, \"median_ns\": %.2f, \"p99_ns\": %.2f, \"mops\": %.3f }",
+                    first ? "" : ",", r.name.c_str(), r.threads, r.median_ns, r.p99_ns, r.mops );
+            } else {
+                printf( "%-22s %3u thread(s)  median %9.2f ns  p99 %9.2f ns  %10.3f Mops/s\n",
+                    r.name.c_str(), r.threads, r.median_ns, r.p99_ns, r.mops );
+            }
+            fflush( stdout );
+            first = false;
+        }
+    }
+    if( json ) printf( "\n  ],\n  \"clock_drift\": [" );
+
+    const char *sources[] = { "realtime", "coarse", "tsc" };
+    first = true;
+    for( int src = sole::clock_realtime; src <= sole::clock_tsc; ++src ) {
+        std::string name = std::string( "clock drift (" ) + sources[src] + ")";
+        if( !filter.empty() && name.find( filter ) == std::string::npos ) continue;
+        sole::set_clock_source( sole::clock_source( src ) );
+        bool usable = sole::get_clock_source() == src;
+        double mean_ns = 0, worst_ns = 0;
+        if( usable ) bench::drift( sole::clock_source( src ), mean_ns, worst_ns );
+        sole::set_clock_source( sole::clock_realtime );
+        if( json ) {
+            printf( "%s\n    { \"source\": \"%s\", \"supported\": %s, \"mean_ns\": %.0f, \"max_ns\": %.0f }",
+                first ? "" : ",", sources[src], usable ? "true" : "false", mean_ns, worst_ns );
+        } else if( usable ) {
+            printf( "%-22s mean %9.0f ns  max %9.0f ns\n", name.c_str(), mean_ns, worst_ns );
+        } else {
+            printf( "%-22s unsupported here\n", name.c_str() );
+        }
+        first = false;
+    }
+    if( json ) printf( "\n  ]\n}\n" );
+}
+
+#endif
+
+#ifdef SOLE_BUILD_STRESS
+// g++ users: `g++ stress.cc -std=c++11 -O2 -pthread -lrt -o stress`
+// visual studio: `cl.exe /O2 stress.cc`
+// usage: stress [--ids N] [--threads N] [--procs N] [--window N] [--versions 01467]
+//
+// Generates ids from N threads (and N forked processes, each with N threads) and checks
+// them for duplicates within a sliding window of the most recent ids, so memory stays
+// bounded on runs of billions of ids.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace stress
+{
+    // Lock-striped duplicate filter. Every shard keeps two generations of ids; when the
+    // current one fills up it becomes the previous one and the oldest is forgotten, so
+    // at least the last `window` ids (and at most twice that) are remembered.
+    class dedupe {
+    public:
+        explicit dedupe( size_t window ) : cap( std::max( window / shards, size_t( 1024 ) ) ), table( new shard[ shards ] ) {
+            for( size_t i = 0; i < shards; ++i ) table[i].current.reserve( cap ), table[i].previous.reserve( cap );
+        }
+
+        bool insert( const sole::uuid &u ) { // false if u was seen within the window
+            shard &s = table[ ( sole::mix_hash()( u ) >> 16 ) % shards ];
+            std::lock_guard<std::mutex> lock( s.mutex );
+            if( s.previous.contains( u ) || !s.current.insert( u ) ) return false;
+            if( s.current.size() >= cap ) {
+                std::swap( s.current, s.previous );
+                s.current.clear();
+            }
+            return true;
+        }
+
+        size_t memory_usage() const {
+            size_t bytes = 0;
+            for( size_t i = 0; i < shards; ++i ) bytes += table[i].current.memory_usage() + table[i].previous.memory_usage();
+            return bytes;
+        }
+
+    private:
+        enum : size_t { shards = 256 };
+        struct shard {
+            std::mutex mutex;
+            sole::uuid_set current, previous;
+        };
+        size_t cap;
+        std::unique_ptr<shard[]> table;
+    };
+
+    struct report {
+        std::atomic<uint64_t> ids, duplicates, disorders; // disorders: v6/v7 not increasing within a thread
+        std::atomic<uint64_t> gen_ns;                     // time spent inside the generators, all threads
+        std::atomic<uint64_t> regressions, saturations;
+    };
+
+    inline sole::uuid generate( int version ) {
+        switch( version ) {
+            case 0: return sole::uuid0();
+            case 1: return sole::uuid1();
+            case 6: return sole::uuid6();
+            case 7: return sole::uuid7();
+            default: return sole::uuid4();
+        }
+    }
+
+    // Generates `count` ids in batches and hands every batch to `sink`.
+    template<typename SINK>
+    inline void produce( int version, uint64_t count, report &r, const SINK &sink ) {
+        enum { batch = 256 };
+        sole::uuid ids[ batch ], last = { 0, 0 };
+        for( uint64_t done = 0; done < count; ) {
+            size_t n = size_t( std::min<uint64_t>( batch, count - done ) );
+            auto then = std::chrono::steady_clock::now();
+            for( size_t i = 0; i < n; ++i ) ids[i] = generate( version );
+            r.gen_ns += uint64_t( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - then ).count() );
+            if( version == 6 || version == 7 )
+                for( size_t i = 0; i < n; last = ids[i++] ) r.disorders += !( last < ids[i] );
+            sink( ids, n );
+            done += n;
+        }
+    }
+
+    inline void consume( dedupe &seen, report &r, const sole::uuid *ids, size_t n ) {
+        uint64_t dups = 0;
+        for( size_t i = 0; i < n; ++i ) dups += !seen.insert( ids[i] );
+        r.ids += n;
+        r.duplicates += dups;
+    }
+
+    // Clock counters are process-wide totals, so runs report what they added.
+    inline void add_clock_counters( report &r, const sole::clock_counters &before ) {
+        sole::clock_counters after = sole::get_clock_counters();
+        r.regressions += after.regressions - before.regressions;
+        r.saturations += after.saturations - before.saturations;
+    }
+
+    inline void run_threads( int version, uint64_t count, unsigned threads, dedupe &seen, report &r ) {
+        sole::clock_counters before = sole::get_clock_counters();
+        std::vector<std::thread> pool;
+        for( unsigned t = 0; t < threads; ++t )
+            pool.emplace_back( [&, t]() {
+                uint64_t share = count / threads + ( t < count % threads );
+                produce( version, share, r, [&]( const sole::uuid *ids, size_t n ) { consume( seen, r, ids, n ); } );
+            } );
+        for( auto &th : pool ) th.join();
+        add_clock_counters( r, before );
+    }
+
+#ifndef _WIN32
+    inline bool write_all( int fd, const void *data, size_t len ) {
+        for( const char *p = (const char *)data; len; ) {
+            ssize_t w = ::write( fd, p, len );
+            if( w <= 0 ) return false;
+            p += w, len -= size_t( w );
+        }
+        return true;
+    }
+
+    // Children generate and stream raw ids through a pipe, then a trailer with their
+    // counters: an all-ones marker (no valid uuid has version 15) and {regressions, saturations}
+    // followed by {disorders, gen_ns}. The parent dedupes every stream.
+    inline void run_procs( int version, uint64_t count, unsigned procs, unsigned threads, dedupe &seen, report &r ) {
+        std::vector<int> fds;
+        std::vector<pid_t> pids;
+        for( unsigned p = 0; p < procs; ++p ) {
+            int fd[2];
+            if( pipe( fd ) != 0 ) { perror( "pipe" ); exit( 1 ); }
+            pid_t pid = fork();
+            if( pid < 0 ) { perror( "fork" ); exit( 1 ); }
+            if( pid == 0 ) {
+                close( fd[0] );
+                sole::clock_counters before = sole::get_clock_counters();
+                report mine = {};
+                std::mutex out;
+                std::vector<std::thread> pool;
+                uint64_t share = count / procs + ( p < count % procs );
+                for( unsigned t = 0; t < threads; ++t )
+                    pool.emplace_back( [&, t]() {
+                        produce( version, share / threads + ( t < share % threads ), mine, [&]( const sole::uuid *ids, size_t n ) {
+                            std::lock_guard<std::mutex> lock( out );
+                            write_all( fd[1], ids, n * sizeof(sole::uuid) );
+                        } );
+                    } );
+                for( auto &th : pool ) th.join();
+                add_clock_counters( mine, before );
+                sole::uuid trailer[3] = { { ~0ULL, ~0ULL }, { mine.regressions, mine.saturations }, { mine.disorders, mine.gen_ns } };
+                write_all( fd[1], trailer, sizeof(trailer) );
+                close( fd[1] );
+                _exit( 0 );
+            }
+            close( fd[1] );
+            fds.push_back( fd[0] );
+            pids.push_back( pid );
+        }
+
+        std::vector<std::thread> readers;
+        for( int fd : fds )
+            readers.emplace_back( [&, fd]() {
+                // the trailer is the last three ids of the stream, so always hold three back
+                enum { trailer = 3 };
+                std::vector<sole::uuid> buf( 4096 );
+                size_t have = 0; // bytes in buf
+                for( ssize_t got; ( got = ::read( fd, (char *)buf.data() + have, buf.size() * sizeof(sole::uuid) - have ) ) > 0; ) {
+                    have += size_t( got );
+                    size_t n = have / sizeof(sole::uuid);
+                    if( n <= trailer ) continue;
+                    consume( seen, r, buf.data(), n - trailer );
+                    have -= ( n - trailer ) * sizeof(sole::uuid);
+                    std::memmove( buf.data(), buf.data() + n - trailer, have );
+                }
+                if( have == trailer * sizeof(sole::uuid) && buf[0].ab == ~0ULL && buf[0].cd == ~0ULL ) {
+                    r.regressions += buf[1].ab, r.saturations += buf[1].cd;
+                    r.disorders += buf[2].ab, r.gen_ns += buf[2].cd;
+                } else {
+                    fprintf( stderr, "stress: child stream ended without a trailer\n" );
+                    r.duplicates += 1;
+                }
+                close( fd );
+            } );
+        for( auto &th : readers ) th.join();
+        for( pid_t pid : pids ) waitpid( pid, 0, 0 );
+    }
+#endif
+}
+
+int main( int argc, char **argv ) {
+    uint64_t ids = 10000000, window = 4000000;
+    unsigned max_threads = std::max( 1u, std::thread::hardware_concurrency() ), procs = 1;
+    std::string versions = "01467";
+    for( int i = 1; i + 1 < argc; i += 2 ) {
+        if( !strcmp( argv[i], "--ids" ) ) ids = strtoull( argv[i + 1], 0, 10 );
+        else if( !strcmp( argv[i], "--threads" ) ) max_threads = std::max( 1, atoi( argv[i + 1] ) );
+        else if( !strcmp( argv[i], "--procs" ) ) procs = std::max( 1, atoi( argv[i + 1] ) );
+        else if( !strcmp( argv[i], "--window" ) ) window = strtoull( argv[i + 1], 0, 10 );
+        else if( !strcmp( argv[i], "--versions" ) ) versions = argv[i + 1];
+    }
+#ifdef _WIN32
+    procs = 1;
+#endif
+
+    std::vector<unsigned> thread_counts;
+    for( unsigned t = 1; t < max_threads; t *= 2 ) thread_counts.push_back( t );
+    thread_counts.push_back( max_threads );
+
+    int failures = 0;
+    for( char v : versions ) {
+        int version = v - '0';
+        for( unsigned threads : thread_counts ) {
+            stress::dedupe seen( (size_t)window );
+            stress::report r = {};
+            auto then = std::chrono::steady_clock::now();
+#ifndef _WIN32
+            if( procs > 1 ) stress::run_procs( version, ids, procs, threads, seen, r );
+            else
+#endif
+            stress::run_threads( version, ids, threads, seen, r );
+            double secs = std::chrono::duration<double>( std::chrono::steady_clock::now() - then ).count();
+
+            printf( "v%d %3u thread(s) x %u proc(s): %llu ids, %llu duplicates, %llu disorders, %llu clock regressions, %llu saturations, "
+                    "%.2f Mids/s total, %.1f ns/id generating, %zu MiB dedupe\n",
+                version, threads, procs, (unsigned long long)r.ids.load(), (unsigned long long)r.duplicates.load(),
+                (unsigned long long)r.disorders.load(), (unsigned long long)r.regressions.load(), (unsigned long long)r.saturations.load(),
+                r.ids / secs / 1e6, r.ids ? double( r.gen_ns ) / r.ids : 0.0, seen.memory_usage() >> 20 );
+            fflush( stdout );
+            failures += r.duplicates || r.disorders || r.ids != ids;
+        }
+    }
+    return failures ? 1 : 0;
+}
+
+#endif
+
+#ifdef SOLE_BUILD_TESTS
+// g++ users: `g++ sole.cxx -std=c++11 -pthread -lrt -o tests`
+// visual studio: `cl.exe sole.cxx`
+
+#include <cassert>
+#include <set>
+#include <ratio>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <map>
+#include <unordered_set>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+using namespace sole;
+
+namespace run
+{
+    auto epoch = [](){
+        return std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
+    };
+
+    template<typename FN>
+    void tests( const FN &fn ) {
+        unsigned numtests = ~0;
+        std::cout << "Testing for " << numtests << " collisions... " << std::endl;
+
+        auto then = epoch();
+
+        std::set<uuid> all;
+        for( unsigned i = 0; i < numtests; ++i ) {
+            auto now = epoch();
+            if( now != then ) {
+                then = now;
+                double pct6digs = ( int( ( double(i) / (unsigned)(~0) ) * 1e4 ) / double(1e4) );
+                std::cout << '\r' << i << " uuids generated, no collision (" << pct6digs << "%)" << std::flush;
+            }
+            sole::uuid my_uuid = fn();
+            assert( all.find(my_uuid) == all.end() && "error: UUIDs just collided! is std::random_device a real random generator?" );
+            all.insert( my_uuid );
+        }
+    }
+
+    template<typename FN>
+    void batch( const FN &fn, int version ) {
+        std::cout << "Verifying batch of 100000 UUIDs v" << version << "... " << std::flush;
+
+        std::vector<sole::uuid> v = fn( 100000 );
+        std::set<sole::uuid> all( v.begin(), v.end() );
+        assert( all.size() == v.size() && "error: batch generated duplicates" );
+        for( auto &u : v ) {
+            assert( int( ( u.ab >> 12 ) & 0xF ) == version && "error: bad version bits" );
+            assert( ( version == 0 || ( u.cd >> 62 ) == 2 ) && "error: bad variant bits" );
+        }
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void node() {
+        std::cout << "Verifying node id override... " << std::flush;
+
+        uint64_t mac = sole::uuid1().cd & 0xFFFFFFFFFFFFULL;
+        sole::set_node( 0x0123456789ABULL );
+        assert( ( sole::uuid0().cd & 0xFFFFFFFFFFFFULL ) == 0x0123456789ABULL && "error: set_node() ignored" );
+        assert( ( sole::uuid1().cd & 0xFFFFFFFFFFFFULL ) == 0x0123456789ABULL && "error: set_node() ignored" );
+        sole::reset_node();
+        assert( ( sole::uuid1().cd & 0xFFFFFFFFFFFFULL ) == mac && "error: reset_node() failed" );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void ordered() {
+        std::cout << "Verifying uuid7() is strictly increasing... " << std::flush;
+
+        std::vector<sole::uuid> batch( 1000 );
+        sole::uuid last = sole::uuid7();
+        for( int i = 0; i < 1000; ++i ) {
+            for( int j = 0; j < 1000; ++j ) {
+                sole::uuid u = sole::uuid7();
+                assert( last < u && "error: uuid7() went backwards" );
+                last = u;
+            }
+            sole::uuid7_n( batch.data(), batch.size() );
+            for( auto &u : batch ) {
+                assert( last < u && "error: uuid7_n() went backwards" );
+                assert( ( u.ab >> 12 & 0xF ) == 7 && ( u.cd >> 62 ) == 2 && "error: bad version/variant" );
+                last = u;
+            }
+        }
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void parsing() {
+        std::cout << "Verifying parse() forms and errors... " << std::flush;
+
+        auto check = []( const char *text, sole::parse_error expected ) {
+            sole::uuid u = { 0, 0 };
+            sole::parse_error err = sole::parse( text, std::strlen( text ), u );
+            assert( err == expected && "error: parse() returned unexpected code" );
+            assert( ( err != sole::parse_ok || u == sole::rebuild( 0xf81d4fae7dec11d0ULL, 0xa76500a0c91e6bf6ULL ) ) && "error: parse() decoded wrong value" );
+        };
+
+        check( "f81d4fae-7dec-11d0-a765-00a0c91e6bf6", sole::parse_ok );
+        check( "F81D4FAE-7DEC-11D0-A765-00A0C91E6BF6", sole::parse_ok );
+        check( "f81d4fae7dec11d0a76500a0c91e6bf6", sole::parse_ok );
+        check( "{f81d4fae-7dec-11d0-a765-00a0c91e6bf6}", sole::parse_ok );
+        check( "urn:uuid:f81d4fae-7dec-11d0-a765-00a0c91e6bf6", sole::parse_ok );
+        check( "URN:UUID:f81d4fae-7dec-11d0-a765-00a0c91e6bf6", sole::parse_ok );
+        check( "LIhsBrTE21A-EN2J2swqbwM", sole::parse_ok );
+        check( "f81d4fae-7dec-11d0-a765-00a0c91e6bfg", sole::parse_bad_char );
+        check( "f81d4fae-7dec-11d0-a765 00a0c91e6bf6", sole::parse_bad_format );
+        check( "(f81d4fae-7dec-11d0-a765-00a0c91e6bf6)", sole::parse_bad_format );
+        check( "f81d4fae-7dec-11d0-a765-00a0c91e6bf", sole::parse_bad_length );
+        check( "LIhsBrTE21A_EN2J2swqbwM", sole::parse_bad_format );
+        check( "LIhsBrTE21A-EN2J2swqbw!", sole::parse_bad_char );
+        check( "zzzzzzzzzzz-0", sole::parse_overflow );
+        check( "LygHa16AHYG-0", sole::parse_overflow ); // 2^64
+        std::cout << "ok" << std::endl;
+    }
+
+    void base62() {
+        std::cout << "Verifying fixed-width base62... " << std::flush;
+
+        sole::uuid known = sole::rebuild( "f81d4fae-7dec-11d0-a765-00a0c91e6bf6" );
+        assert( known.base62() == "LIhsBrTE21A-EN2J2swqbwM" && "error: legacy base62 output changed" );
+        sole::uuid small = sole::rebuild( 0, 61 );
+        assert( small.base62() == "0-z" && small.base62( true ) == "00000000000-0000000000z" );
+        sole::uuid max = sole::rebuild( ~0ULL, ~0ULL );
+        assert( max.base62( true ) == "LygHa16AHYF-LygHa16AHYF" && sole::rebuild( max.base62() ) == max );
+
+        std::vector<sole::uuid> ids = sole::uuid4_n( 10000 );
+        ids.push_back( small ), ids.push_back( max ), ids.push_back( sole::rebuild( 0, 0 ) );
+        std::vector<std::pair<std::string, sole::uuid>> texts;
+        for( auto &id : ids ) {
+            texts.push_back( std::make_pair( id.base62( true ), id ) );
+            assert( texts.back().first.size() == sole::uuid::base62_max_size && sole::rebuild( texts.back().first ) == id );
+        }
+        std::sort( ids.begin(), ids.end() );
+        std::sort( texts.begin(), texts.end() );
+        for( size_t i = 0; i < ids.size(); ++i )
+            assert( texts[i].second == ids[i] && "error: fixed base62 does not sort like operator<" );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void lines() {
+        std::cout << "Verifying encode_lines()/decode_lines()... " << std::flush;
+
+        std::vector<sole::uuid> ids = sole::uuid4_n( 100000 ), back;
+        std::string text( ids.size() * ( sole::uuid::str_size + 1 ), '\0' );
+        size_t written = sole::encode_lines( ids.data(), ids.size(), &text[0], 4 );
+        assert( written == text.size() ); (void)written;
+        assert( text.substr( 0, sole::uuid::str_size + 1 ) == ids[0].str() + "\n" );
+
+        sole::lines_result r = sole::decode_lines( text.data(), text.size(), back, 4 );
+        assert( r.error == sole::parse_ok && r.count == ids.size() && back == ids && "error: decode_lines() failed" );
+
+        text[ 777 * ( sole::uuid::str_size + 1 ) + 3 ] = 'x';
+        back.clear();
+        r = sole::decode_lines( text.data(), text.size(), back, 3 );
+        assert( r.error == sole::parse_bad_char && r.bad_line == 777 && back.size() == 777 && "error: decode_lines() missed bad line" );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    // Compares bulk codec against per-item str()/rebuild().
+    void codec() {
+        std::vector<sole::uuid> ids = sole::uuid4_n( 1000000 ), back;
+        std::string text( ids.size() * ( sole::uuid::str_size + 1 ), '\0' );
+        unsigned hw = std::thread::hardware_concurrency();
+        hw = hw ? hw : 1;
+
+        auto timed = [&]( const std::string &name, const std::function<void()> &fn ) {
+            auto then = std::chrono::steady_clock::now();
+            fn();
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - then ).count();
+            std::cout << "Benchmarking " << name << "... " << ms << " ms per 1M lines" << std::endl;
+        };
+
+        timed( "encode (str)", [&]() {
+            std::string s;
+            s.reserve( text.size() );
+            for( auto &id : ids ) s += id.str(), s += '\n';
+        } );
+        timed( "encode_lines (1 thread)", [&]() { sole::encode_lines( ids.data(), ids.size(), &text[0] ); } );
+        timed( "encode_lines (all threads)", [&]() { sole::encode_lines( ids.data(), ids.size(), &text[0], hw ); } );
+        timed( "decode (rebuild)", [&]() {
+            std::istringstream is( text );
+            std::string line;
+            back.clear();
+            while( std::getline( is, line ) ) back.push_back( sole::rebuild( line ) );
+        } );
+        timed( "decode_lines (1 thread)", [&]() { back.clear(); sole::decode_lines( text.data(), text.size(), back ); } );
+        timed( "decode_lines (all threads)", [&]() { back.clear(); sole::decode_lines( text.data(), text.size(), back, hw ); } );
+    }
+
+    // Bucket distribution and lookup latency of a hash policy over given keys.
+    template<typename HASH>
+    void hashing( const std::vector<sole::uuid> &keys, const std::string &name ) {
+        std::unordered_set<sole::uuid, HASH> set( keys.begin(), keys.end() );
+
+        // expected chain walked by a successful lookup: sum(size^2) / n; ideal is ~1.5 at load 1
+        size_t longest = 0;
+        double walked = 0;
+        for( size_t b = 0; b < set.bucket_count(); ++b ) {
+            size_t n = set.bucket_size( b );
+            longest = n > longest ? n : longest;
+            walked += double( n ) * n;
+        }
+
+        // same, for a power-of-two table indexed by low hash bits (open addressing tables)
+        std::vector<unsigned> pow2( 1 << 20 );
+        HASH hash;
+        size_t longest2 = 0;
+        for( auto &k : keys ) {
+            unsigned n = ++pow2[ hash( k ) & ( pow2.size() - 1 ) ];
+            longest2 = n > longest2 ? n : longest2;
+        }
+
+        std::vector<sole::uuid> probes( keys );
+        std::shuffle( probes.begin(), probes.end(), std::mt19937( 42 ) );
+        auto then = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for( auto &k : probes ) found += set.count( k );
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - then ).count();
+
+        std::cout << "Benchmarking hash " << name << "... " << double( ns ) / found << " ns/lookup, "
+            << "longest bucket " << longest << ", avg chain " << walked / keys.size()
+            << ", longest pow2 bucket " << longest2 << std::endl;
+    }
+
+    void hashing() {
+        std::vector<sole::uuid> keys[3] = { sole::uuid0_n( 1000000 ), sole::uuid1_n( 1000000 ), sole::uuid4_n( 1000000 ) };
+        const char *names[3] = { "v0", "v1", "v4" };
+        for( int i = 0; i < 3; ++i ) {
+            hashing<sole::xor_hash>( keys[i], std::string( names[i] ) + " xor_hash" );
+            hashing<sole::mix_hash>( keys[i], std::string( names[i] ) + " mix_hash" );
+            hashing<sole::keyed_hash>( keys[i], std::string( names[i] ) + " keyed_hash" );
+        }
+    }
+
+    void tables() {
+        std::cout << "Verifying uuid_set/uuid_map against std containers... " << std::flush;
+
+        std::mt19937 rng( 7 );
+        std::vector<sole::uuid> keys = sole::uuid4_n( 5000 );
+        sole::uuid_set set;
+        sole::uuid_map<std::string> map( 100 );
+        std::unordered_set<sole::uuid> ref;
+        for( int op = 0; op < 200000; ++op ) {
+            const sole::uuid &k = keys[ rng() % keys.size() ];
+            if( rng() % 3 ) {
+                bool a = set.insert( k ), b = ref.insert( k ).second;
+                assert( a == b ); (void)a, (void)b;
+                map[k] = k.str();
+            } else {
+                bool a = set.erase( k ), b = ref.erase( k ) == 1;
+                assert( a == b ); (void)a, (void)b;
+                map.erase( k );
+            }
+            assert( set.size() == ref.size() && map.size() == ref.size() );
+        }
+        for( auto &k : keys ) {
+            assert( set.contains( k ) == ( ref.count( k ) == 1 ) );
+            const std::string *v = map.find( k );
+            assert( ref.count( k ) ? v && *v == k.str() : !v );
+        }
+        size_t visited = 0;
+        set.for_each( [&]( const sole::uuid_slot<void> &slot ) { visited += ref.count( slot.key ); } );
+        assert( visited == ref.size() );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    // insert, hit lookup and miss lookup against std::unordered_set
+    template<typename SET, typename INSERT, typename FIND>
+    void table( const std::string &name, const INSERT &insert, const FIND &find ) {
+        std::vector<sole::uuid> keys = sole::uuid4_n( 1000000 ), misses = sole::uuid4_n( 1000000 );
+        auto ns = []( std::chrono::steady_clock::time_point since ) {
+            return double( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - since ).count() );
+        };
+
+        SET set;
+        auto then = std::chrono::steady_clock::now();
+        for( auto &k : keys ) insert( set, k );
+        double ins = ns( then ) / keys.size();
+
+        std::shuffle( keys.begin(), keys.end(), std::mt19937( 1 ) );
+        size_t found = 0;
+        then = std::chrono::steady_clock::now();
+        for( auto &k : keys ) found += find( set, k );
+        double hit = ns( then ) / keys.size();
+
+        then = std::chrono::steady_clock::now();
+        for( auto &k : misses ) found += find( set, k );
+        double miss = ns( then ) / keys.size();
+
+        assert( found == keys.size() );
+        std::cout << "Benchmarking " << name << "... insert " << ins << " ns, hit " << hit << " ns, miss " << miss << " ns" << std::endl;
+    }
+
+    void tables_bench() {
+        table< std::unordered_set<sole::uuid> >( "std::unordered_set",
+            []( std::unordered_set<sole::uuid> &s, const sole::uuid &k ) { s.insert( k ); },
+            []( const std::unordered_set<sole::uuid> &s, const sole::uuid &k ) { return s.count( k ); } );
+        table< sole::uuid_set >( "sole::uuid_set",
+            []( sole::uuid_set &s, const sole::uuid &k ) { s.insert( k ); },
+            []( const sole::uuid_set &s, const sole::uuid &k ) { return size_t( s.contains( k ) ); } );
+
+        sole::uuid_set reserved( 1000000 );
+        for( auto &k : sole::uuid4_n( 1000000 ) ) reserved.insert( k );
+        std::cout << "Memory of sole::uuid_set with 1M keys: " << reserved.memory_usage() / 1024 << " KiB" << std::endl;
+    }
+
+    void bytes() {
+        std::cout << "Verifying binary layout... " << std::flush;
+
+        const uint8_t wire[16] = { 0xf8,0x1d,0x4f,0xae, 0x7d,0xec, 0x11,0xd0, 0xa7,0x65, 0x00,0xa0,0xc9,0x1e,0x6b,0xf6 };
+        const uint8_t guid[16] = { 0xae,0x4f,0x1d,0xf8, 0xec,0x7d, 0xd0,0x11, 0xa7,0x65, 0x00,0xa0,0xc9,0x1e,0x6b,0xf6 };
+        sole::uuid u = sole::rebuild( "f81d4fae-7dec-11d0-a765-00a0c91e6bf6" );
+        uint8_t b[16];
+        sole::to_bytes( u, b );
+        assert( !memcmp( b, wire, 16 ) && "error: to_bytes() failed" );
+        assert( sole::from_bytes( wire ) == u && "error: from_bytes() failed" );
+        sole::to_guid_bytes( u, b );
+        assert( !memcmp( b, guid, 16 ) && "error: to_guid_bytes() failed" );
+        assert( sole::from_guid_bytes( guid ) == u && "error: from_guid_bytes() failed" );
+
+        // bulk paths agree with the scalar ones, in place too
+        std::vector<sole::uuid> ids = sole::uuid4_n( 1001 ), back( ids.size() );
+        std::vector<uint8_t> raw( ids.size() * 16 ), one( 16 );
+        sole::to_bytes( ids.data(), ids.size(), raw.data() );
+        for( size_t i = 0; i < ids.size(); ++i ) {
+            sole::to_bytes( ids[i], one.data() );
+            assert( !memcmp( &raw[16 * i], one.data(), 16 ) && "error: bulk to_bytes() failed" );
+            // memcmp order of wire bytes is operator< order
+            if( i ) assert( ( memcmp( &raw[16 * i - 16], &raw[16 * i], 16 ) < 0 ) == ( ids[i - 1] < ids[i] ) );
+        }
+        sole::from_bytes( raw.data(), ids.size(), back.data() );
+        assert( back == ids && "error: bulk from_bytes() failed" );
+        sole::to_guid_bytes( ids.data(), ids.size(), raw.data() );
+        for( size_t i = 0; i < ids.size(); ++i ) {
+            sole::to_guid_bytes( ids[i], one.data() );
+            assert( !memcmp( &raw[16 * i], one.data(), 16 ) && "error: bulk to_guid_bytes() failed" );
+        }
+        back = ids;
+        sole::to_guid_bytes( back.data(), back.size(), (uint8_t *)back.data() );
+        sole::from_guid_bytes( (const uint8_t *)back.data(), back.size(), back.data() );
+        assert( back == ids && "error: in-place guid round trip failed" );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void decoding() {
+        std::cout << "Verifying decode()... " << std::flush;
+
+        sole::uuid_info i = sole::decode( sole::rebuild( "f81d4fae-7dec-11d0-a765-00a0c91e6bf6" ) );
+        assert( i.version == 1 && i.variant == 1 && i.node == 0x00a0c91e6bf6ULL && i.clock_seq == 10085 );
+        assert( i.timestamp == 8549917922168750ULL && "error: decode() v1 timestamp failed" );
+        // RFC 9562 v1, v6 and v7 examples share one creation time
+        for( auto s : { "C232AB00-9414-11EC-B3C8-9F6BDECED846", "1EC9414C-232A-6B00-B3C8-9F6BDECED846", "017F22E2-79B0-7CC3-98C4-DC0C0C07398F" } ) {
+            sole::uuid u = sole::rebuild( s );
+            assert( sole::decode( u ).timestamp == 16455577420000000ULL && "error: decode() timestamp failed" );
+            assert( u.pretty( true ).find( "timestamp=2022-02-22T19:22:22.0000000Z," ) != std::string::npos && "error: pretty(true) failed" );
+        }
+        i = sole::decode( sole::rebuild( "00aed2f9-c5f8-0030-0fd8-00ffb77bd832" ) );
+        assert( i.version == 0 && i.pid == 4056 && i.node == 0x00ffb77bd832ULL );
+        i = sole::decode( sole::rebuild( "fa237b32-d580-42db-aeb9-b09a1d90067e" ) );
+        assert( i.version == 4 && i.variant == 1 && i.bits_hi == 0xfa237b32d58002dbULL && i.bits_lo == 0x2eb9b09a1d90067eULL );
+
+        // UTC formatter against gmtime() over a few centuries
+        std::mt19937_64 rng( 42 );
+        for( int n = 0; n < 10000; ++n ) {
+            std::time_t secs = std::time_t( rng() % 10000000000ULL );
+            char ours[32], theirs[32];
+            *sole::write_iso8601( ours, uint64_t( secs ) * 10000000 ) = '\0';
+            std::strftime( theirs, sizeof(theirs), "%Y-%m-%dT%H:%M:%S.0000000Z", std::gmtime( &secs ) );
+            assert( !strcmp( ours, theirs ) && "error: write_iso8601() failed" );
+        }
+
+        std::vector<sole::uuid> ids = sole::uuid1_n( 100 );
+        std::vector<sole::uuid_info> infos( ids.size() );
+        sole::decode_n( ids.data(), ids.size(), infos.data() );
+        for( size_t n = 1; n < ids.size(); ++n ) assert( infos[n].timestamp > infos[n - 1].timestamp && infos[n].node == infos[0].node );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void names() {
+        std::cout << "Verifying uuid3/uuid5... " << std::flush;
+
+        // reference values from Python's uuid module; lengths around the one-block limit
+        struct { std::string name; const char *v3, *v5; } dns[] = {
+            { "python.org", "6fa459ea-ee8a-3ca4-894e-db77e160355e", "886313e1-3b8a-5372-9b90-0c9aee199e5d" },
+            { "www.example.com", "5df41881-3aed-3515-88a7-2f4a814cf09e", "2ed6657d-e927-568b-95e1-2665a8aea6a2" },
+            { "", "c87ee674-4ddc-3efe-a74e-dfe25da5d7b3", "4ebd0208-8328-5d69-8c44-ec50939c0967" },
+            { std::string( 39, 'a' ), "96cb729a-b665-38ba-b98f-a35a1d044728", "5824f981-4282-59d4-9716-acb6d741350e" },
+            { std::string( 40, 'b' ), "8571026e-c511-3d50-906c-5ed1b770fc38", "2b73eccb-a8ca-5339-8c5e-56586a0ae9eb" },
+            { std::string( 55, 'c' ), "f2a38313-511b-3d64-bfab-24df8484b08c", "c998122d-cb8f-576f-ae59-646f9a5f73ea" },
+            { std::string( 56, 'd' ), "72e34817-c947-365f-95cc-fc9380552d43", "15ccdb23-df3e-59a2-a0e3-67ac4214ec71" },
+            { std::string( 119, 'e' ), "47aa76d4-3ea0-385e-b6dd-f09fd58c2131", "6fe821c7-57b7-5199-be17-d9bc6df0393a" },
+            { std::string( 200, 'f' ), "4074b737-fa1e-3681-991c-754ccffbfad3", "51cf76bc-6e98-5798-b8ab-c7fda6c71b90" },
+        };
+        std::vector<std::string> names;
+        for( auto &t : dns ) {
+            assert( sole::uuid3( sole::ns_dns, t.name ).str() == t.v3 && "error: uuid3() failed" );
+            assert( sole::uuid5( sole::ns_dns, t.name ).str() == t.v5 && "error: uuid5() failed" );
+            names.push_back( t.name );
+        }
+        assert( sole::uuid5( sole::ns_url, "https://example.com/x" ).str() == "49517db3-5541-5e91-9cd4-395dd68a97ac" );
+        assert( sole::uuid3( sole::ns_oid, "1.2.3" ).str() == "8c29ab0e-a2dc-3482-b5eb-20cb2e2387a1" );
+        assert( sole::uuid5( sole::ns_x500, "cn=x" ).str() == "a951fb6d-5aab-5a72-8e2e-9aa8df8d1f8f" );
+
+        // batch: SIMD lanes, long names and leftovers agree with the one-by-one path
+        for( int i = 0; i < 50; ++i ) names.push_back( std::string( size_t( i ), char( 'A' + i % 26 ) ) );
+        std::vector<sole::uuid> v3 = sole::uuid3_n( sole::ns_dns, names ), v5 = sole::uuid5_n( sole::ns_dns, names );
+        for( size_t i = 0; i < names.size(); ++i ) {
+            assert( v3[i] == sole::uuid3( sole::ns_dns, names[i] ) && "error: uuid3_n() failed" );
+            assert( v5[i] == sole::uuid5( sole::ns_dns, names[i] ) && "error: uuid5_n() failed" );
+        }
+        assert( sole::uuid5( sole::ns_dns, "python.org" ).pretty().find( "version=5,hash=" ) == 0 );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void columns() {
+        std::cout << "Verifying column codec... " << std::flush;
+
+        std::vector<sole::uuid> ids;
+        for( auto &v : { sole::uuid0_n( 5000 ), sole::uuid1_n( 3000 ), sole::uuid4_n( 1500 ), sole::uuid6_n( 2500 ) } )
+            ids.insert( ids.end(), v.begin(), v.end() );
+        // mixed block, varying seq/node, clock going backwards
+        ids[5100] = sole::uuid0();
+        for( size_t i = 6000; i < 6100; ++i ) ids[i].cd ^= i << 40;
+        std::swap( ids[6200], ids[6900] );
+
+        sole::column_encoder enc;
+        for( size_t at = 0, step = 1; at < ids.size(); at += step, step = step * 3 % 2000 + 1 )
+            enc.push( &ids[at], std::min( step, ids.size() - at ) );
+        enc.finish();
+
+        sole::column_decoder dec( enc.bytes().data(), enc.bytes().size() );
+        std::vector<sole::uuid> back;
+        assert( dec.ok() && dec.size() == ids.size() && "error: column index failed" );
+        bool decoded = dec.decode( back );
+        assert( decoded && back == ids && "error: column round trip failed" );
+        for( size_t i = 0; i < ids.size(); i += 997 ) assert( dec.at( i ) == ids[i] && "error: column at() failed" );
+
+        // corrupt streams are rejected, not misread, and decode() appends nothing
+        std::vector<uint8_t> bad( enc.bytes().begin(), enc.bytes().end() - 1 );
+        sole::column_decoder truncated( bad.data(), bad.size() );
+        assert( !truncated.ok() );
+        decoded = truncated.decode( back );
+        assert( !decoded && back == ids && "error: column decode() kept ids of a truncated stream" );
+        bad = enc.bytes(), bad[ bad.size() - 1 ] |= 0x80;
+        decoded = sole::column_decoder( bad.data(), bad.size() ).decode( back );
+        assert( !decoded && back == ids && "error: column decode() kept ids of a corrupt block" );
+        // first block holds v0 ids: version byte, then flags, after the block header
+        assert( enc.bytes()[ sole::column_header - 1 ] == sole::column_mode_time && enc.bytes()[ sole::column_header ] == 0 );
+        for( int field : { 0, 1 } )
+            for( uint8_t value : { 4, 7, 0x10 } ) {
+                bad = enc.bytes(), bad[ sole::column_header + field ] = value;
+                sole::column_decoder corrupt( bad.data(), bad.size() );
+                sole::uuid block[ sole::column_block ];
+                size_t written = corrupt.decode_block( 0, block );
+                decoded = corrupt.decode( back );
+                assert( corrupt.ok() && !written && "error: column decode_block() misread a bad version or flags" );
+                assert( !decoded && back == ids && corrupt.at( 0 ) == sole::uuid( { 0, 0 } ) );
+                (void)written;
+            }
+        (void)decoded;
+
+        std::cout << "ok" << std::endl;
+    }
+
+    template<typename FN>
+    void columns_bench( const FN &fn, const std::string &name ) {
+        std::vector<sole::uuid> ids = fn( 1000000 ), back;
+        back.reserve( ids.size() );
+        auto secs = []( std::chrono::steady_clock::time_point since ) {
+            return std::chrono::duration<double>( std::chrono::steady_clock::now() - since ).count();
+        };
+
+        auto then = std::chrono::steady_clock::now();
+        sole::column_encoder enc;
+        enc.push( ids.data(), ids.size() );
+        enc.finish();
+        double enc_s = secs( then );
+
+        then = std::chrono::steady_clock::now();
+        sole::column_decoder( enc.bytes().data(), enc.bytes().size() ).decode( back );
+        double dec_s = secs( then );
+
+        double raw = double( ids.size() * sizeof(sole::uuid) );
+        std::cout << "Benchmarking column codec " << name << "... " << ( raw / enc.bytes().size() ) << "x smaller, encode "
+                  << ( raw / enc_s / 1e9 ) << " GB/s, decode " << ( raw / dec_s / 1e9 ) << " GB/s" << std::endl;
+    }
+
+    void sorting() {
+        std::cout << "Verifying radix sorts... " << std::flush;
+
+        for( size_t n : { size_t(0), size_t(1), size_t(100), size_t(5000), size_t(200000) } ) {
+            std::vector<sole::uuid> input = sole::uuid4_n( n );
+            // duplicates and keys that differ only in low bytes
+            for( size_t i = 0; i + 1 < n; i += 7 ) input[i] = input[i + 1];
+            for( size_t i = 0; i < n; i += 5 ) input[i].ab = 42, input[i].cd = i % 300;
+            std::vector<sole::uuid> expected = input;
+            std::sort( expected.begin(), expected.end() );
+
+            std::vector<sole::uuid> a = input, b = input, c = input;
+            sole::sort( a.data(), a.data() + n );
+            sole::sort_inplace( b.data(), b.data() + n );
+            sole::sort_parallel( c.data(), c.data() + n, 4 );
+            assert( a == expected && "error: sort() failed" );
+            assert( b == expected && "error: sort_inplace() failed" );
+            assert( c == expected && "error: sort_parallel() failed" );
+        }
+
+        // time-ordered ids: top bytes constant, partition must pick a lower byte
+        std::vector<sole::uuid> v7 = sole::uuid7_n( 200000 ), v7r( v7.rbegin(), v7.rend() );
+        sole::sort_parallel( v7r.data(), v7r.data() + v7r.size(), 4 );
+        assert( v7r == v7 && "error: sort_parallel() failed on v7" );
+
+        // sorted and shuffled v0/v1 take the LSD path over their varying bytes
+        std::vector<sole::uuid> (*makers[])( size_t ) = { &sole::uuid0_n, &sole::uuid1_n };
+        for( auto make : makers ) {
+            std::vector<sole::uuid> ids = make( 200000 ), expected;
+            std::shuffle( ids.begin(), ids.end(), std::mt19937( 1 ) );
+            expected = ids;
+            std::sort( expected.begin(), expected.end() );
+            sole::sort( ids.data(), ids.data() + ids.size() );
+            assert( ids == expected && "error: sort() failed on shuffled time-ordered ids" );
+            sole::sort( ids.data(), ids.data() + ids.size() );
+            assert( ids == expected && "error: sort() failed on sorted ids" );
+        }
+
+        std::cout << "ok" << std::endl;
+    }
+
+    template<typename FN>
+    void sorting_bench( const FN &fn, const std::string &name, bool shuffled = false ) {
+        std::vector<sole::uuid> keys( 4000000 );
+        for( auto &k : keys ) k = fn();
+        if( shuffled ) std::shuffle( keys.begin(), keys.end(), std::mt19937( 1 ) );
+
+        auto time = [&]( const char *algo, const std::function<void( sole::uuid *, sole::uuid * )> &sort ) {
+            std::vector<sole::uuid> v = keys;
+            auto then = std::chrono::steady_clock::now();
+            sort( v.data(), v.data() + v.size() );
+            auto ms = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - then ).count();
+            std::cout << "Benchmarking sort " << name << " (" << algo << ", " << keys.size() << " ids)... " << ms << " ms" << std::endl;
+        };
+        time( "std::sort", []( sole::uuid *f, sole::uuid *l ) { std::sort( f, l ); } );
+        time( "sole::sort", []( sole::uuid *f, sole::uuid *l ) { sole::sort( f, l ); } );
+        time( "sole::sort_inplace", []( sole::uuid *f, sole::uuid *l ) { sole::sort_inplace( f, l ); } );
+        time( "sole::sort_parallel", []( sole::uuid *f, sole::uuid *l ) { sole::sort_parallel( f, l ); } );
+    }
+
+    void v6() {
+        std::cout << "Verifying v1 <-> v6 conversion... " << std::flush;
+
+        // RFC 9562 appendix A.5 test vector
+        sole::uuid ids[3] = {
+            sole::rebuild("C232AB00-9414-11EC-B3C8-9F6BDECED846"),
+            sole::uuid4(),
+            sole::rebuild("1EC9414C-232A-6B00-B3C8-9F6BDECED846")
+        };
+        sole::uuid copy[3] = { ids[0], ids[1], ids[2] };
+        sole::v1_to_v6( ids, 3 );
+        assert( ids[0] == copy[2] && ids[1] == copy[1] && ids[2] == copy[2] && "error: v1_to_v6() failed" );
+        sole::v6_to_v1( ids, 3 );
+        assert( ids[0] == copy[0] && ids[1] == copy[1] && ids[2] == copy[0] && "error: v6_to_v1() failed" );
+
+        std::vector<sole::uuid> v = sole::uuid6_n( 1000 );
+        v.push_back( sole::uuid6() );
+        assert( std::is_sorted( v.begin(), v.end() ) && "error: uuid6() does not sort chronologically" );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    // Inserts ids in creation order into ordered containers: time-ordered keys append
+    // at the end, random keys land all over the tree/array.
+    template<typename FN>
+    void locality( const FN &fn, const std::string &name ) {
+        std::cout << "Benchmarking insert locality " << name << "... " << std::flush;
+
+        auto ms = []( std::chrono::steady_clock::time_point since ) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - since ).count();
+        };
+
+        std::vector<sole::uuid> keys( 1000000 );
+        for( auto &k : keys ) k = fn();
+
+        auto then = std::chrono::steady_clock::now();
+        std::map<sole::uuid, int> map;
+        for( auto &k : keys ) map.emplace( k, 0 );
+        auto map_ms = ms( then );
+
+        then = std::chrono::steady_clock::now();
+        std::vector<sole::uuid> sorted;
+        for( size_t i = 0; i < 50000; ++i )
+            sorted.insert( std::lower_bound( sorted.begin(), sorted.end(), keys[i] ), keys[i] );
+        auto vec_ms = ms( then );
+
+        std::cout << "std::map (1M): " << map_ms << " ms, sorted vector (50K): " << vec_ms << " ms" << std::endl;
+    }
+
+    void threads() {
+        std::cout << "Verifying timestamps are unique across 4 threads... " << std::flush;
+
+        enum { per_thread = 100000 };
+        std::vector<uint64_t> ticks[4];
+        std::vector<std::thread> pool;
+        for( auto &v : ticks ) {
+            pool.emplace_back( [&v]() {
+                for( int i = 0; i < per_thread; ++i ) v.push_back( sole::get_time( 0 ) );
+                for( int i = 0; i < per_thread / 100; ++i ) {
+                    uint64_t t = sole::get_time_range( 0, 100 );
+                    for( int j = 0; j < 100; ++j ) v.push_back( t + j );
+                }
+            } );
+        }
+        for( auto &t : pool ) t.join();
+
+        std::set<uint64_t> all;
+        for( auto &v : ticks ) all.insert( v.begin(), v.end() );
+        assert( all.size() == 4 * 2 * per_thread && "error: get_time() handed out the same tick twice" );
+
+        std::cout << "ok (" << sole::get_clock_counters().saturations << " saturations, "
+            << sole::get_clock_counters().regressions << " regressions)" << std::endl;
+    }
+
+    void forks() {
+#ifndef _WIN32
+        std::cout << "Verifying uuid1() clock sequence set by set_clock_seq() is redrawn after fork()... " << std::flush;
+
+        // a child may redraw the same sequence by chance (1 in 16384): retry a few times
+        bool redrawn = false;
+        for( uint16_t attempt = 0; attempt < 4 && !redrawn; ++attempt ) {
+            uint16_t seq = uint16_t( 0x1234 + attempt );
+            sole::set_clock_seq( seq );
+            sole::uuid1();
+
+            int fd[2];
+            int rc = pipe(fd);
+            assert( rc == 0 ); (void)rc;
+            pid_t pid = fork();
+            if( pid == 0 ) {
+                uint16_t child = sole::get_clock_seq();
+                ssize_t w = write( fd[1], &child, sizeof(child) );
+                _exit( w == sizeof(child) ? 0 : 1 );
+            }
+            uint16_t theirs = seq;
+            ssize_t got = read( fd[0], &theirs, sizeof(theirs) );
+            assert( got == sizeof(theirs) ); (void)got;
+            waitpid( pid, 0, 0 );
+            close( fd[0] ), close( fd[1] );
+            assert( sole::get_clock_seq() == seq );
+            redrawn = theirs != seq;
+        }
+        assert( redrawn && "error: child process reused parent's clock sequence" );
+
+        std::cout << "ok" << std::endl;
+        std::cout << "Verifying uuid4() streams and uuid0() pid diverge after fork()... " << std::flush;
+
+        sole::uuid4(); // warm up engine so the child inherits a buffered state
+        sole::uuid0(); // warm up pid cache
+
+        int fd[2];
+        int rc = pipe(fd);
+        assert( rc == 0 ); (void)rc;
+        pid_t pid = fork();
+        if( pid == 0 ) {
+            sole::uuid child[2] = { sole::uuid4(), sole::uuid0() };
+            ssize_t w = write( fd[1], child, sizeof(child) );
+            _exit( w == sizeof(child) ? 0 : 1 );
+        }
+        sole::uuid mine = sole::uuid4(), theirs[2] = { { 0, 0 }, { 0, 0 } };
+        ssize_t got = read( fd[0], theirs, sizeof(theirs) );
+        assert( got == sizeof(theirs) ); (void)got;
+        waitpid( pid, 0, 0 );
+        close( fd[0] ), close( fd[1] );
+        assert( mine != theirs[0] && "error: child process repeated parent's random stream" );
+        assert( ( theirs[1].cd >> 48 ) == ( uint64_t(pid) & 0xFFFF ) && "error: child process reused parent's pid" );
+
+        std::cout << "ok" << std::endl;
+#endif
+    }
+
+    void stats() {
+        std::cout << "Verifying sole::stats() counters... " << std::flush;
+
+        sole::stats_snapshot before = sole::stats();
+        std::thread( []() {
+            sole::uuid ids[100];
+            sole::uuid0(), sole::uuid1(), sole::uuid4(), sole::uuid6(), sole::uuid7();
+            sole::uuid0_n( ids, 100 ), sole::uuid1_n( ids, 100 ), sole::uuid4_n( ids, 100 ), sole::uuid6_n( ids, 100 ), sole::uuid7_n( ids, 100 );
+            std::string names[9] = { "a", "b", "c", "d", "e", "f", "g", "h", std::string( 100, 'i' ) };
+            sole::uuid3( sole::ns_dns, "x" ), sole::uuid5( sole::ns_dns, "x" );
+            sole::uuid3_n( sole::ns_dns, names, 9, ids ), sole::uuid5_n( sole::ns_dns, names, 9, ids );
+            sole::rebuild( "not-an-uuid" ), sole::rebuild( ids[0].str() );
+        } ).join();
+        sole::stats_snapshot after = sole::stats();
+
+        uint64_t generated[8];
+        for( int v = 0; v < 8; ++v ) generated[v] = after.generated[v] - before.generated[v];
+#ifdef SOLE_ENABLE_STATS
+        for( int v : { 0, 1, 4, 6, 7 } ) assert( generated[v] == 101 && "error: stats() miscounted generated ids" );
+        for( int v : { 3, 5 } ) assert( generated[v] == 10 && "error: stats() miscounted name-based ids" );
+        assert( after.parse_failures - before.parse_failures == 1 && "error: stats() miscounted parse failures" );
+        assert( after.random_bytes - before.random_bytes >= 100 * sizeof(sole::uuid) && "error: stats() missed random bytes" );
+#else
+        for( int v = 0; v < 8; ++v ) assert( generated[v] == 0 && "error: stats() counted with SOLE_ENABLE_STATS undefined" );
+#endif
+        assert( after.clock_saturations >= before.clock_saturations && after.clock_regressions >= before.clock_regressions );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void clocks() {
+        std::cout << "Verifying clock sources... " << std::flush;
+
+        for( sole::clock_source src : { sole::clock_realtime, sole::clock_coarse, sole::clock_tsc } ) {
+            sole::set_clock_source( src );
+            sole::clock_source got = sole::get_clock_source();
+            assert( ( got == src || got == sole::clock_realtime ) && "error: set_clock_source()" );
+
+            // ids stay unique and increasing per thread, also while the tsc source calibrates
+            enum { threads = 4, per_thread = 50000 };
+            std::vector<sole::uuid> ids( threads * per_thread );
+            std::vector<std::thread> workers;
+            for( unsigned t = 0; t < threads; ++t )
+                workers.emplace_back( [&, t]() {
+                    sole::uuid *mine = &ids[ t * per_thread ];
+                    for( size_t i = 0; i < per_thread; ++i ) {
+                        mine[i] = sole::uuid6();
+                        assert( ( !i || mine[i - 1] < mine[i] ) && "error: v6 ids went backwards" );
+                    }
+                } );
+            for( auto &th : workers ) th.join();
+            sole::uuid_set seen;
+            for( auto &u : ids ) {
+                bool fresh = seen.insert( u );
+                assert( fresh && "error: duplicate timestamp" ); (void)fresh;
+            }
+
+            // past calibration, the source tracks CLOCK_REALTIME within a few ms
+            std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+            int64_t worst = 0;
+            for( int i = 0; i < 100; ++i ) {
+                int64_t d = sole::clock_drift();
+                worst = std::max( worst, d < 0 ? -d : d );
+                std::this_thread::sleep_for( std::chrono::microseconds( 200 ) );
+            }
+            assert( worst < 200000 && "error: clock source drifted more than 20 ms" );
+            std::cout << ( got == sole::clock_realtime ? "realtime" : got == sole::clock_coarse ? "coarse" : "tsc" )
+                << " (drift " << worst / 10 << " us) " << std::flush;
+        }
+        sole::set_clock_source( sole::clock_realtime );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void deterministic() {
+        std::cout << "Verifying deterministic_generator... " << std::flush;
+
+        // golden values: xoshiro256** seeded by splitmix64(42), clock starting at 0
+        sole::deterministic_generator g( 42 );
+        sole::uuid g4 = g.uuid4(), g1 = g.uuid1();
+        assert( g4 == "ae175332-39e4-49a1-acb8-ad4703b360a1"_uuid && "error: v4 stream changed" );
+        assert( g1 == "13814000-1dd2-11b2-9578-0b2e0c2ec716"_uuid && "error: v1 fields changed" );
+        sole::deterministic_generator jumped( 42 );
+        jumped.jump();
+        uint64_t word = jumped.next();
+        assert( word == 0x77369f9f12449a8bULL && "error: jump() changed" );
+
+        // same seed, same streams; ordered and unique time-based ids
+        sole::deterministic_generator a( 7, 16000000000000000ULL, 10 ), b( 7, 16000000000000000ULL, 10 );
+        sole::uuid last[5] = {};
+        for( int i = 0; i < 10000; ++i ) {
+            sole::uuid ua[5] = { a.uuid0(), a.uuid1(), a.uuid4(), a.uuid6(), a.uuid7() };
+            sole::uuid ub[5] = { b.uuid0(), b.uuid1(), b.uuid4(), b.uuid6(), b.uuid7() };
+            for( int k = 0; k < 5; ++k ) {
+                assert( ua[k] == ub[k] && "error: same seed gave different ids" );
+                assert( sole::decode( ua[k] ).version == unsigned( "01467"[k] - '0' ) && "error: wrong version" );
+                if( k == 3 || k == 4 ) assert( ( !i || last[k] < ua[k] ) && "error: v6/v7 ids not increasing" );
+                last[k] = ua[k];
+            }
+        }
+        // 10000 rounds of 4 time-based ids, 10 ticks each
+        sole::uuid tick = a.uuid1();
+        assert( sole::decode( tick ).timestamp == 16000000000000000ULL + 10 * 4 * 10000 && "error: virtual clock" );
+
+        // jumped substreams do not overlap
+        sole::deterministic_generator streams[3] = { sole::deterministic_generator( 1 ), sole::deterministic_generator( 1 ), sole::deterministic_generator( 1 ) };
+        streams[1].jump(), streams[2].jump(), streams[2].jump();
+        sole::uuid_set seen;
+        for( auto &gen : streams )
+            for( int i = 0; i < 100000; ++i ) {
+                bool fresh4 = seen.insert( gen.uuid4() ), fresh1 = seen.insert( gen.uuid1() );
+                assert( fresh4 && "error: jumped streams overlap" );
+                assert( fresh1 && "error: jumped streams share time-based ids" );
+                (void)fresh4, (void)fresh1;
+            }
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void extraction() {
+        std::cout << "Verifying bulk extractors and time_index... " << std::flush;
+
+        std::vector<sole::uuid> mixed;
+        for( auto &v : { sole::uuid0_n( 1001 ), sole::uuid1_n( 1001 ), sole::uuid4_n( 1001 ), sole::uuid6_n( 1001 ), sole::uuid7_n( 1001 ) } )
+            mixed.insert( mixed.end(), v.begin(), v.end() );
+        mixed.push_back( sole::uuid3( sole::ns_dns, "example.com" ) );
+        mixed.push_back( sole::uuid{ 0, 0 } );
+        std::shuffle( mixed.begin(), mixed.end(), std::mt19937( 1 ) );
+
+        size_t n = mixed.size();
+        std::vector<uint8_t> versions( n );
+        std::vector<uint64_t> stamps( n ), nodes( n );
+        std::vector<uint16_t> seqs( n );
+        sole::extract_versions( mixed.data(), n, versions.data() );
+        sole::extract_timestamps( mixed.data(), n, stamps.data() );
+        sole::extract_nodes( mixed.data(), n, nodes.data() );
+        sole::extract_sequences( mixed.data(), n, seqs.data() );
+        for( size_t i = 0; i < n; ++i ) {
+            sole::uuid_info info = sole::decode( mixed[i] );
+            assert( versions[i] == info.version && stamps[i] == info.timestamp && nodes[i] == info.node && "error: extractors disagree with decode()" );
+            assert( seqs[i] == ( info.version == 0 ? info.pid : info.clock_seq ) && "error: extract_sequences() disagrees with decode()" );
+        }
+
+        // creation-ordered v0/v1/v6 mix, 10 ticks apart: id k was made at start + 10k
+        const uint64_t start = 16000000000000000ULL;
+        sole::deterministic_generator g( 3, start, 10 );
+        std::vector<sole::uuid> ids( 100000 );
+        for( size_t k = 0; k < ids.size(); ++k ) ids[k] = k % 3 == 0 ? g.uuid0() : k % 3 == 1 ? g.uuid1() : g.uuid6();
+        for( size_t stride : { 1, 7, 256, 1000000 } ) {
+            sole::time_index index( ids.data(), ids.size(), stride );
+            assert( index.ok() && "error: time_index rejected ordered ids" );
+            for( uint64_t t0 : { uint64_t( 0 ), start - 1, start, start + 5, start + 10, start + 123457, start + 999990, start + 2000000 } )
+                for( uint64_t len : { 0, 1, 10, 11, 99999, 10000000 } ) {
+                    std::pair<size_t, size_t> r = index.range( t0, t0 + len );
+                    auto first = [&]( uint64_t t ) { return t <= start ? 0 : std::min<size_t>( ids.size(), size_t( ( t - start + 9 ) / 10 ) ); };
+                    size_t lo = first( t0 ), hi = std::max( lo, first( t0 + len ) );
+                    assert( ( len ? r == std::make_pair( lo, hi ) : r.first == r.second ) && "error: time_index range" );
+                }
+        }
+        std::reverse( ids.begin(), ids.end() );
+        assert( !sole::time_index( ids.data(), ids.size(), 16 ).ok() && "error: time_index accepted unordered ids" );
+
+        std::cout << "ok" << std::endl;
+    }
+
+    void pool() {
+        std::cout << "Verifying sole::pool hands out unique ids, refills and survives fork()... " << std::flush;
+
+        sole::pool p( 1u << 4 | 1u << 7, 1024 );
+        for( int i = 0; i < 10000 && ( p.stats( 4 ).fill < 1024 || p.stats( 7 ).fill < 1024 ); ++i ) std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        assert( p.stats( 4 ).fill == 1024 && p.stats( 7 ).fill == 1024 && "error: pool did not fill up" );
+
+        enum { threads = 4, per_thread = 20000 };
+        std::vector<sole::uuid> ids( threads * per_thread );
+        std::vector<std::thread> workers;
+        for( unsigned t = 0; t < threads; ++t )
+            workers.emplace_back( [&, t]() {
+                for( size_t i = 0; i < per_thread; ++i ) ids[ t * per_thread + i ] = p.take( t & 1 ? 7 : 4 );
+            } );
+        for( auto &th : workers ) th.join();
+
+        sole::uuid_set seen;
+        for( size_t i = 0; i < ids.size(); ++i ) {
+            bool fresh = seen.insert( ids[i] );
+            assert( fresh && "error: pool handed out a duplicate" ); (void)fresh;
+            assert( sole::decode( ids[i] ).version == ( ( i / per_thread ) & 1 ? 7u : 4u ) && "error: pool handed out wrong version" );
+        }
+        sole::pool::counters c4 = p.stats( 4 ), c7 = p.stats( 7 ), c1 = p.stats( 1 );
+        assert( c4.hits + c4.misses == threads / 2 * per_thread && c7.hits + c7.misses == threads / 2 * per_thread );
+        assert( c4.hits >= 1024 && c4.refills >= c4.hits && "error: pool counters" );
+        sole::uuid inline_v1 = p.take( 1 );
+        assert( c1.hits == 0 && c1.misses == 0 && sole::decode( inline_v1 ).version == 1 && "error: disabled version" );
+
+#ifndef _WIN32
+        for( int i = 0; i < 10000 && p.stats( 4 ).fill < 1024; ++i ) std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        int fd[2];
+        int rc = pipe(fd);
+        assert( rc == 0 ); (void)rc;
+        pid_t pid = fork();
+        if( pid == 0 ) {
+            sole::uuid child[64];
+            for( auto &u : child ) u = p.take( 4 );
+            ssize_t w = write( fd[1], child, sizeof(child) );
+            _exit( w == sizeof(child) ? 0 : 1 );
+        }
+        close( fd[1] );
+        sole::uuid mine[64], theirs[64];
+        for( auto &u : mine ) u = p.take( 4 );
+        ssize_t got = read( fd[0], theirs, sizeof(theirs) );
+        assert( got == sizeof(theirs) && "error: child process failed" ); (void)got;
+        waitpid( pid, 0, 0 );
+        close( fd[0] );
+        sole::uuid_set parent( 64 );
+        for( auto &u : mine ) parent.insert( u );
+        for( auto &u : theirs ) assert( !parent.contains( u ) && "error: child process took ids from parent's pool" );
+#endif
+
+        std::cout << "ok" << std::endl;
+    }
+
+    template<typename FN>
+    void verify( const FN &fn ) {
+        std::cout << "Verifying serialization of 1 million UUIDs... " << std::flush;
+
+        for( unsigned i = 0; i < 1000000; ++i ) {
+            sole::uuid uuid = fn();
+            sole::uuid rebuilt1 = sole::rebuild( uuid.str() );
+            sole::uuid rebuilt2 = sole::rebuild( uuid.base62() );
+            char upper[ sole::uuid::str_size ];
+            sole::uuid rebuilt3 = sole::rebuild( std::string( upper, uuid.write_str( upper, true ) ) );
             assert( rebuilt1 == uuid && "error: rebuild() or .str() failed" );
             assert( rebuilt2 == uuid && "error: rebuild() or .base62() failed" );
+            assert( rebuilt3 == uuid && "error: rebuild() or .write_str() failed" );
         }
 
         std::cout << "ok" << std::endl;
     }
 }
 
+// compile-time literals and comparisons
+static_assert( "f81d4fae-7dec-11d0-a765-00a0c91e6bf6"_uuid == sole::uuid{ 0xf81d4fae7dec11d0ULL, 0xa76500a0c91e6bf6ULL }, "_uuid" );
+static_assert( "{F81D4FAE-7DEC-11D0-A765-00A0C91E6BF6}"_uuid == "f81d4fae7dec11d0a76500a0c91e6bf6"_uuid, "_uuid" );
+static_assert( "00000000-0000-0000-0000-000000000001"_uuid < "00000000-0000-0000-0000-000000000002"_uuid, "operator<" );
+
 int main() {
     assert( sizeof(sole::uuid      )  * 8 == 128 );
     assert( sizeof(sole::uuid0().ab)  * 8 ==  64 );
     assert( sizeof(sole::uuid0().cd)  * 8 ==  64 );
 
-    run::benchmark(uuid0, "v0");
-    run::benchmark(uuid1, "v1");
-    run::benchmark(uuid4, "v4");
-
-    auto uustr = uuid4().str();
-    run::benchmark([=]() { sole::rebuild( uustr ); }, "rebuild");
-
-    auto uuid = uuid4();
-    run::benchmark([=]() { uuid.str(); }, "str");
+    run::codec();
+    run::hashing();
+    run::tables_bench();
+    run::columns_bench([]( size_t n ) { return sole::uuid0_n( n ); }, "v0");
+    run::columns_bench([]( size_t n ) { return sole::uuid1_n( n ); }, "v1");
+    run::columns_bench([]( size_t n ) { return sole::uuid4_n( n ); }, "v4");
+    run::sorting_bench(uuid4, "v4");
+    run::sorting_bench(uuid1, "v1");
+    run::sorting_bench(uuid0, "v0");
+    run::sorting_bench(uuid1, "v1 shuffled", true);
+    run::sorting_bench(uuid0, "v0 shuffled", true);
+
+    run::locality(uuid4, "v4");
+    run::locality(uuid7, "v7");
 
     run::verify(uuid4);             // use fastest implementation
+    run::verify(uuid7);
+    run::parsing();
+    run::base62();
+    run::lines();
+    run::tables();
+    run::bytes();
+    run::decoding();
+    run::names();
+    run::columns();
+    run::sorting();
+    run::ordered();
+    run::v6();
+    run::node();
+    run::threads();
+    run::forks();
+    run::pool();
+    run::stats();
+    run::clocks();
+    run::deterministic();
+    run::extraction();
+    run::batch([]( size_t n ) { return sole::uuid0_n( n ); }, 0);
+    run::batch([]( size_t n ) { return sole::uuid1_n( n ); }, 1);
+    run::batch([]( size_t n ) { return sole::uuid4_n( n ); }, 4);
+    run::batch([]( size_t n ) { return sole::uuid6_n( n ); }, 6);
+    run::batch([]( size_t n ) { return sole::uuid7_n( n ); }, 7);
 
 //  run::tests(uuid0);              // not applicable
 //  run::tests(uuid1);              // not applicable
@@ -0,0 +1,2 @@
+#define SOLE_BUILD_STRESS
+#include "sole.hpp"